@@ -31,6 +31,8 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "sid_global.h"
+
 #include <Arduino.h>
 
 #include "input.h"
@@ -39,80 +41,150 @@
  * IRRemote class
  */
 
-#define TMR_TIME      0.00005    // 0.00005s = 50us
-#define TMR_PRESCALE  80
-#define TMR_TICKS     (uint64_t)(((double)TMR_TIME * 80000000.0) / (double)TMR_PRESCALE)
-#define TME_TIMEUS    (TMR_TIME * 1000000)
+/*
+ * Marks and spaces are timed by a GPIO interrupt on every edge of
+ * the IR receiver's output, with timestamps taken from the free-
+ * running microsecond timer (micros()). Unlike sampling the pin 
+ * from a timer interrupt, this costs nothing while no remote is in
+ * use. Since there is no edge at the end of a transmission, the 
+ * final gap is detected in loop() - or in the ISR, if the next 
+ * transmission starts before loop() noticed.
+ * Durations are stored in us; calcHash() only looks at the ratios.
+ *
+ * Completed transmissions are put into a queue (single producer: 
+ * ISR, single consumer: loop()), so that codes received while the
+ * main loop is busy (text sequences, blocking delays) are not lost.
+ * The ISR always records into the slot at the head, which becomes 
+ * visible to loop() when the transmission is complete. If the queue
+ * is full, the transmission is dropped and counted as overflow. 
+ * The hash is calculated in loop() when a frame is taken from the 
+ * queue.
+ */
 
 #define GAP_DUR 5000  // Minimum gap between transmissions in us (microseconds)
-#define GAP_TICKS     (GAP_DUR / TME_TIMEUS)
 
 // IR receiver pin polarity
 #define IR_LIGHT  0
 #define IR_DARK   1
 
-static void IRAM_ATTR IRTimer_ISR();
+typedef struct {
+    unsigned long when;       // micros() at start of transmission
+    unsigned long end;        // micros() at end of last mark
+    uint32_t      len;
+    uint32_t      buf[IRBUFSIZE];
+} IRFrame;
+
+static void IRAM_ATTR IREdge_ISR();
 
 static uint8_t _ir_pin;
 
-static volatile uint32_t _cnt = 0;
+static portMUX_TYPE _irMux = portMUX_INITIALIZER_UNLOCKED;
+
+static volatile unsigned long _lastEdge = 0;
 static volatile IRState  _irstate = IRSTATE_IDLE;
 static volatile uint32_t _irlen = 0;
-static volatile uint32_t _irbuf[IRBUFSIZE];
+
+static volatile IRFrame  _irq[IRQUEUESIZE];
+static volatile uint8_t  _qHead = 0;      // Written by ISR
+static volatile uint8_t  _qTail = 0;      // Written by loop()
+static volatile uint32_t _qOverflow = 0;
+
+// Called from ISR when a transmission is complete
+static void (* volatile _wakeFunc)() = NULL;
+
+// Queue recorded transmission, go back to idle
+// Called with _irMux held
+static void IRAM_ATTR IRFinish(unsigned long end)
+{
+    uint8_t next = (_qHead + 1) % IRQUEUESIZE;
+    
+    _irq[_qHead].len = _irlen;
+    _irq[_qHead].end = end;
+    if(next != _qTail) {
+        _qHead = next;
+    } else {
+        _qOverflow++;
+    }
+    _irstate = IRSTATE_IDLE;
+}
 
 // ISR 
 // Record duration of marks/spaces through a simple state machine
-static void IRAM_ATTR IRTimer_ISR()
+static void IRAM_ATTR IREdge_ISR()
 {
+    unsigned long now = micros();
     uint8_t irpin = (uint8_t)digitalRead(_ir_pin);
+    uint32_t dur;
+    volatile uint32_t *irbuf;
+    bool done = false, queued = false;
+
+    portENTER_CRITICAL_ISR(&_irMux);
 
-    _cnt++;
+    dur = now - _lastEdge;
+    irbuf = _irq[_qHead].buf;
     
     switch(_irstate) {
     case IRSTATE_IDLE:
         if(irpin == IR_LIGHT) {
-            if(_cnt >= GAP_TICKS) {
+            if(dur >= GAP_DUR) {
                 // Current gap longer than minimum gap size,
                 // start recording.
                 // (In case of a smaller gap, we assume being in 
                 // the middle of a transmission whose start we 
                 // missed. Do nothing then.
                 _irstate = IRSTATE_LIGHT;
-                _irbuf[0] = _cnt;  // First is length of previous gap
+                _irq[_qHead].when = now;
+                irbuf[0] = dur;  // First is length of previous gap
                 _irlen = 1;
             }
-            _cnt = 0;
         }
         break;
     case IRSTATE_LIGHT:
         if(irpin == IR_DARK) {
             _irstate = IRSTATE_DARK;
-            _irbuf[_irlen++] = _cnt;
-            _cnt = 0;
-            if(_irlen >= IRBUFSIZE) _irstate = IRSTATE_STOP;
+            irbuf[_irlen++] = dur;
+            if(_irlen >= IRBUFSIZE) done = true;
         }
         break;
     case IRSTATE_DARK:
         if(irpin == IR_LIGHT) {
-            _irstate = IRSTATE_LIGHT;
-            _irbuf[_irlen++] = _cnt;
-            _cnt = 0;
-            if(_irlen >= IRBUFSIZE) _irstate = IRSTATE_STOP;
-        } else if(_cnt > GAP_TICKS) {
-            // Gap longer than usual space, transmission finished.
-            _irstate = IRSTATE_STOP;
+            if(dur > GAP_DUR) {
+                // Gap longer than usual space, transmission 
+                // finished; loop() did not notice yet. Queue 
+                // it, and start recording the new one.
+                IRFinish(_lastEdge);
+                queued = true;
+                _irstate = IRSTATE_LIGHT;
+                _irq[_qHead].when = now;
+                _irq[_qHead].buf[0] = dur;
+                _irlen = 1;
+            } else {
+                _irstate = IRSTATE_LIGHT;
+                irbuf[_irlen++] = dur;
+                if(_irlen >= IRBUFSIZE) done = true;
+            }
         }
         break;
-    case IRSTATE_STOP:
-        if(irpin == IR_LIGHT) _cnt = 0; // Reset cnt whenever we see something, even if we miss recording it
-        break;
+    }
+
+    if(done) {
+        IRFinish(now);
+        queued = true;
+    }
+
+    // Every edge counts, even if we miss recording it
+    _lastEdge = now;
+
+    portEXIT_CRITICAL_ISR(&_irMux);
+
+    if(queued && _wakeFunc) {
+        _wakeFunc();
     }
 }
  
 // Store basic config data
-IRRemote::IRRemote(uint8_t timer_no, uint8_t ir_pin)
+IRRemote::IRRemote(uint8_t ir_pin)
 {
-    _timer_no = timer_no;
     _ir_pin = ir_pin;
 }
 
@@ -121,51 +193,88 @@ void IRRemote::begin()
     pinMode(_ir_pin, INPUT);
     _irstate = IRSTATE_IDLE;
     _irlen = 0;
+    _qHead = _qTail = 0;
+    _lastEdge = micros();
 
     // Install & enable interrupt
-    _IRTimer = timerBegin(_timer_no, TMR_PRESCALE, true);
-    timerAttachInterrupt(_IRTimer, &IRTimer_ISR, true);
-    timerAlarmWrite(_IRTimer, TMR_TICKS, true);
-    timerAlarmEnable(_IRTimer);
+    attachInterrupt(_ir_pin, IREdge_ISR, CHANGE);
 }
 
 // Decode IR signal
 bool IRRemote::loop()
 {
-    // No new transmission, bail...
-    if(_irstate != IRSTATE_STOP)
-        return false;
-
-    // Copy result to backup buffer
-    _buflen = _irlen;
-    for(uint8_t i = 0; i < _buflen; i++) {
-        _buf[i] = _irbuf[i];
+    // Last mark followed by a long enough gap: Transmission finished
+    if(_irstate == IRSTATE_DARK) {
+        portENTER_CRITICAL(&_irMux);
+        if(_irstate == IRSTATE_DARK && micros() - _lastEdge > GAP_DUR) {
+            IRFinish(_lastEdge);
+        }
+        portEXIT_CRITICAL(&_irMux);
     }
+    
+    while(_qTail != _qHead) {
+
+        volatile IRFrame *f = &_irq[_qTail];
+        
+        // Copy result to backup buffer
+        _buflen = f->len;
+        for(uint8_t i = 0; i < _buflen; i++) {
+            _buf[i] = f->buf[i];
+        }
+        _time = f->when;
+        _endTime = f->end;
 
-    // Continue recording
-    resume();
+        // Free slot
+        _qTail = (_qTail + 1) % IRQUEUESIZE;
     
-    // Calc hash on received "code"
-    if(calcHash()) {
-        //unsigned long now = millis();
-        // Repeat-key-avoidance hinders game play!
-        //if(_hvalue == _prevHash) {
-        //    if(now - _prevTime < 300) {
-        //        _prevTime = now;
-        //        return false;
-        //    }
-        //}
-        _prevHash = _hvalue;
-        //_prevTime = now;
-        return true;
+        // Decode known protocol, or calc hash on received "code"
+        bool valid = decode();
+
+        #ifdef SID_IR_DUMP
+        dumpFrame(valid);
+        #endif
+        
+        if(valid) {
+            _prevHash = _hvalue;
+            return true;
+        }
     }
 
     return false;
 }
 
+// Drop all received transmissions, start fresh
 void IRRemote::resume()
 {
+    portENTER_CRITICAL(&_irMux);
+    _qTail = _qHead;
     _irstate = IRSTATE_IDLE;
+    portEXIT_CRITICAL(&_irMux);
+}
+
+// micros() at start of transmission of last code
+unsigned long IRRemote::readTime()
+{
+    return _time;
+}
+
+// micros() at end of last code (its last mark)
+unsigned long IRRemote::readEndTime()
+{
+    return _endTime;
+}
+
+// Durations (us) of last code, starting with the gap before it
+const uint32_t *IRRemote::readDurations(uint32_t &len)
+{
+    len = _buflen;
+    return _buf;
+}
+
+// Number of transmissions dropped due to full queue
+uint32_t IRRemote::getOverflow()
+{
+    return _qOverflow;
 }
 
 uint32_t IRRemote::readHash()
@@ -173,6 +282,19 @@ uint32_t IRRemote::readHash()
     return _hvalue;
 }
 
+// Protocol, address, command, repeat flag of last code
+const IRCode& IRRemote::readCode()
+{
+    return _code;
+}
+
+// Set function to be called (in ISR context!) when a 
+// transmission has been received
+void IRRemote::setWakeup(void (*isrFunc)())
+{
+    _wakeFunc = isrFunc;
+}
+
 
 /* CalcHash: Calculate hash over an arbitrary IR code
  * 
@@ -201,17 +323,369 @@ bool IRRemote::calcHash()
     if(_buflen < 6)
         return false;
     
+    _hvalue = hashDurations(_buf, _buflen);
+    
+    return true;
+}
+
+// Timing hash over durations; buf[0] (the gap) is not included
+uint32_t IRRemote::hashDurations(const uint32_t *buf, uint32_t len)
+{
     uint32_t hash = FNV_BASIS_32;
     
-    for(int i = 1; i + 2 < _buflen; i++) {
-        hash = (hash * FNV_PRIME_32) ^ compare(_buf[i], _buf[i+2]);
+    for(int i = 1; i + 2 < len; i++) {
+        hash = (hash * FNV_PRIME_32) ^ compare(buf[i], buf[i+2]);
+    }
+
+    return hash;
+}
+
+/*
+ * Protocol decoders
+ *
+ * NEC, Sony SIRC, RC5 and RC6 (modes 0 and 6) are decoded into 
+ * protocol, address and command. Everything else is identified by
+ * the timing hash only.
+ *
+ * The hash (readHash()) stays the key for the IR code tables: NEC 
+ * and SIRC frames keep their timing hash, so the built-in remote 
+ * and learned codes remain valid. For RC5/RC6, the hash is built 
+ * from the decoded code without the toggle bit, so that every press
+ * of a key gives the same hash.
+ *
+ * NEC repeat frames as well as repeated SIRC/RC5/RC6 frames (same 
+ * code and toggle bit within IR_REPEAT_WIN) are flagged "repeat".
+ */
+
+#define IR_REPEAT_WIN 200000  // Max time in us between starts of repeated frames
+
+// Duration within 65%-135% of nominal value
+#define IR_MATCH(d, nom) ((d) >= (nom) * 65 / 100 && (d) <= (nom) * 135 / 100)
+
+bool IRRemote::decode()
+{
+    IRCode  prev = _code;
+    uint8_t prevToggle = _toggle;
+    bool    recent = (_time - _prevTime < IR_REPEAT_WIN);
+
+    _prevTime = _time;
+    _code.repeat = false;
+    _toggle = 0;
+
+    if(decodeNEC() || decodeSIRC() || decodeRC6() || decodeRC5()) {
+
+        if(_code.repeat) {
+            // NEC repeat frame: Repeats previous NEC code
+            if(!recent || prev.protocol != IRPROTO_NEC)
+                return false;
+            _code = prev;
+            _code.repeat = true;
+            _hvalue = _prevHash;
+            return true;
+        }
+
+        if(recent                              &&
+           _code.protocol != IRPROTO_NEC       &&
+           prev.protocol  == _code.protocol    &&
+           prev.address   == _code.address     &&
+           prev.command   == _code.command     &&
+           prevToggle     == _toggle) {
+            _code.repeat = true;
+        }
+
+        if(_code.protocol == IRPROTO_RC5 || _code.protocol == IRPROTO_RC6) {
+            codeHash();
+            return true;
+        }
+
+        return calcHash();
     }
+
+    _code.protocol = IRPROTO_UNKNOWN;
+    _code.address = _code.command = 0;
     
+    return calcHash();
+}
+
+// FNV-1 hash over decoded code
+void IRRemote::codeHash()
+{
+    uint8_t d[5] = {
+        _code.protocol,
+        (uint8_t)(_code.address & 0xff), (uint8_t)(_code.address >> 8),
+        (uint8_t)(_code.command & 0xff), (uint8_t)(_code.command >> 8)
+    };
+    uint32_t hash = FNV_BASIS_32;
+    
+    for(int i = 0; i < 5; i++) {
+        hash = (hash * FNV_PRIME_32) ^ d[i];
+    }
+
     _hvalue = hash;
+}
+
+// NEC: 9ms mark, 4.5ms space, 32 bits (LSB first; 560us mark, 
+// 560us/1690us space), 560us mark.
+// Repeat frame: 9ms mark, 2.25ms space, 560us mark.
+bool IRRemote::decodeNEC()
+{
+    uint32_t val = 0;
+    
+    if(_buflen < 4 || !IR_MATCH(_buf[1], 9000))
+        return false;
+
+    if(_buflen == 4 && IR_MATCH(_buf[2], 2250)) {
+        _code.protocol = IRPROTO_NEC;
+        _code.repeat = true;
+        return true;
+    }
+
+    if(_buflen < 68 || !IR_MATCH(_buf[2], 4500))
+        return false;
+
+    for(int i = 0; i < 32; i++) {
+        uint32_t mark = _buf[3 + 2*i], space = _buf[4 + 2*i];
+        if(!IR_MATCH(mark, 560))
+            return false;
+        if(IR_MATCH(space, 1690)) {
+            val |= (1UL << i);
+        } else if(!IR_MATCH(space, 560)) {
+            return false;
+        }
+    }
+
+    // Command is followed by its inverse
+    if((((val >> 16) ^ (val >> 24)) & 0xff) != 0xff)
+        return false;
+
+    _code.protocol = IRPROTO_NEC;
+    _code.command = (val >> 16) & 0xff;
+    // Standard NEC: Address followed by its inverse; 
+    // otherwise extended NEC with 16 bit address
+    if(((val ^ (val >> 8)) & 0xff) == 0xff) {
+        _code.address = val & 0xff;
+    } else {
+        _code.address = val & 0xffff;
+    }
     
     return true;
 }
 
+// Sony SIRC: 2.4ms mark, 600us space, 12, 15 or 20 bits (LSB first; 
+// 600us/1200us mark, 600us space). 7 bits command, rest address.
+bool IRRemote::decodeSIRC()
+{
+    int bits = ((int)_buflen - 2) / 2;
+    uint32_t val = 0;
+
+    if((_buflen & 1) || (bits != 12 && bits != 15 && bits != 20))
+        return false;
+
+    if(!IR_MATCH(_buf[1], 2400) || !IR_MATCH(_buf[2], 600))
+        return false;
+
+    for(int i = 0; i < bits; i++) {
+        uint32_t mark = _buf[3 + 2*i];
+        if(i < bits - 1 && !IR_MATCH(_buf[4 + 2*i], 600))
+            return false;
+        if(mark < 390 || mark > 1620)
+            return false;
+        if(mark > 900) val |= (1UL << i);
+    }
+
+    _code.protocol = IRPROTO_SIRC;
+    _code.command = val & 0x7f;
+    _code.address = val >> 7;
+
+    return true;
+}
+
+// Split marks/spaces from _buf[first] on into slots of "unit" us
+// (1 = mark, 0 = space) for bi-phase coded protocols. Returns number
+// of slots, or -1 if a duration is not 1-3 units.
+int IRRemote::toSlots(int first, uint32_t unit, uint8_t *slots, int maxSlots)
+{
+    int n = 0;
+    
+    for(int i = first; i < _buflen; i++) {
+        uint32_t u = (_buf[i] + unit / 2) / unit;
+        if(u < 1 || u > 3)
+            return -1;
+        while(u--) {
+            if(n >= maxSlots) return -1;
+            slots[n++] = (i & 1);     // Odd: mark
+        }
+    }
+    
+    return n;
+}
+
+// Bi-phase bit from two slots: Returns 1 if slots are (hi, lo), 
+// 0 if (lo, hi), -1 if no transition
+static int biphase(const uint8_t *slots, uint8_t hi)
+{
+    if(slots[0] == slots[1]) return -1;
+    return (slots[0] == hi) ? 1 : 0;
+}
+
+// RC5: 14 bits (MSB first) of 1778us: start (1), field (inverted 
+// command bit 6), toggle, 5 bits address, 6 bits command. A "1" is
+// space-mark. The first half of the start bit is in the gap.
+bool IRRemote::decodeRC5()
+{
+    uint8_t slots[32];
+    uint32_t val = 0;
+    int n;
+
+    slots[0] = 0;
+    if((n = toSlots(1, 889, &slots[1], 31)) < 0)
+        return false;
+    n++;
+    
+    // Last half (space) of last bit is in the gap
+    if(n & 1) slots[n++] = 0;
+    if(n != 28)
+        return false;
+
+    for(int i = 0; i < 14; i++) {
+        int b = biphase(&slots[i * 2], 0);
+        if(b < 0) return false;
+        val = (val << 1) | b;
+    }
+
+    if(!(val & 0x2000))
+        return false;
+
+    _code.protocol = IRPROTO_RC5;
+    _toggle = (val >> 11) & 1;
+    _code.address = (val >> 6) & 0x1f;
+    _code.command = (val & 0x3f) | ((val & 0x1000) ? 0 : 0x40);
+
+    return true;
+}
+
+// RC6: 2.67ms mark, 889us space, start bit (1), 3 bits mode, toggle 
+// (double length), data (MSB first; mode 0: 8 bits address, 8 bits 
+// command; mode 6: 16 bits each). Half bit is 444us, a "1" is 
+// mark-space.
+bool IRRemote::decodeRC6()
+{
+    uint8_t slots[80];
+    uint32_t val = 0;
+    int mode = 0, n, dbits;
+
+    if(_buflen < 20 || !IR_MATCH(_buf[1], 2666) || !IR_MATCH(_buf[2], 889))
+        return false;
+
+    if((n = toSlots(3, 444, slots, 79)) < 0)
+        return false;
+
+    // Last half (space) of last bit is in the gap
+    if(n & 1) slots[n++] = 0;
+
+    if(n == 44)      dbits = 16;
+    else if(n == 76) dbits = 32;
+    else return false;
+
+    if(biphase(&slots[0], 1) != 1)
+        return false;
+
+    for(int i = 1; i < 4; i++) {
+        int b = biphase(&slots[i * 2], 1);
+        if(b < 0) return false;
+        mode = (mode << 1) | b;
+    }
+
+    // Trailer bit: Double length halves
+    if(slots[8] != slots[9] || slots[10] != slots[11] || slots[9] == slots[10])
+        return false;
+
+    for(int i = 0; i < dbits; i++) {
+        int b = biphase(&slots[12 + i * 2], 1);
+        if(b < 0) return false;
+        val = (val << 1) | b;
+    }
+
+    if(dbits == 16) {
+        if(mode != 0) return false;
+        _toggle = slots[8];
+        _code.address = val >> 8;
+        _code.command = val & 0xff;
+    } else {
+        if(mode != 6) return false;
+        // MCE remotes toggle bit 15 instead of the trailer bit
+        _toggle = slots[8] | (((val >> 15) & 1) << 1);
+        val &= ~0x8000UL;
+        _code.address = val >> 16;
+        _code.command = val & 0xffff;
+    }
+    
+    _code.protocol = IRPROTO_RC6;
+
+    return true;
+}
+
+#ifdef SID_IR_DUMP
+/*
+ * Debug: Print every received transmission as
+ * IR <len> <hash> <protocol> <address> <command> <repeat>: <durations>
+ * (durations in us, starting with the gap before the transmission),
+ * so that traces of remotes can be collected from Serial; the host
+ * tests (test/ir) read this format. For transmissions long enough 
+ * to be hashed, also print how robust the timing hash is: For each
+ * jitter level (every duration deviating by a random amount of up
+ * to +/- n%), the number of IR_JITTER_TRIALS trials that still 
+ * result in the same hash.
+ */
+#define IR_JITTER_TRIALS 20
+
+// Jitter is drawn from a local xorshift32, not from sid_rand, so
+// that dumping does not alter the (seeded) animation sequences
+static uint32_t dumpRand = 0x2545f491;
+
+static uint32_t dumpRandBelow(uint32_t n)
+{
+    dumpRand ^= dumpRand << 13;
+    dumpRand ^= dumpRand >> 17;
+    dumpRand ^= dumpRand << 5;
+    
+    return (uint32_t)(((uint64_t)dumpRand * n) >> 32);
+}
+
+void IRRemote::dumpFrame(bool valid)
+{
+    uint32_t jbuf[IRBUFSIZE];
+    uint32_t thash;
+
+    Serial.printf("IR %u %08x %d %x %x %d:", _buflen, valid ? _hvalue : 0,
+        _code.protocol, _code.address, _code.command, _code.repeat ? 1 : 0);
+    for(int i = 0; i < _buflen; i++) {
+        Serial.printf(" %u", _buf[i]);
+    }
+    Serial.println("");
+
+    if(_buflen < 6)
+        return;
+
+    // Timing hash (RC5/RC6 codes are hashed differently)
+    thash = hashDurations(_buf, _buflen);
+
+    Serial.printf("IR jitter");
+    for(int j = 5; j <= 40; j += 5) {
+        int same = 0;
+        for(int k = 0; k < IR_JITTER_TRIALS; k++) {
+            for(int i = 0; i < _buflen; i++) {
+                uint32_t dev = _buf[i] * j / 100;
+                jbuf[i] = _buf[i] - dev + dumpRandBelow(2 * dev + 1);
+            }
+            if(hashDurations(jbuf, _buflen) == thash) same++;
+        }
+        Serial.printf(" %d%%:%d", j, same);
+    }
+    Serial.printf(" (of %d)\n", IR_JITTER_TRIALS);
+}
+#endif
+
 /*
  * SIDButton class
  * 
@@ -220,6 +694,11 @@ bool IRRemote::calcHash()
  * reported immediately (after PressTicks have elapsed), regardless of a button
  * release. The latter mode is used for when the TCD is connected to trigger
  * time travels.
+ *
+ * After begin(), edges are caught by a pin change interrupt and queued with
+ * their timestamp (micros()); scan() runs the state machine on each queued
+ * edge at the time it occurred, so debounce and press timing do not depend
+ * on how often scan() is called. Without begin(), scan() polls the pin.
  */
 
 /* pin: The pin to be used
@@ -236,6 +715,58 @@ SIDButton::SIDButton(const int pin, const boolean activeLow, const bool pullupAc
 }
 
 
+// Catch edges by interrupt
+void SIDButton::begin()
+{
+    _active = (digitalRead(_pin) == _buttonPressed);
+    _startTime = micros();
+    _qHead = _qTail = 0;
+    _useISR = true;
+    attachInterruptArg(_pin, SIDButton::edgeISR, this, CHANGE);
+}
+
+// Set function to be called (in ISR context!) on every edge
+void SIDButton::setWakeup(void (*isrFunc)())
+{
+    _wakeFunc = isrFunc;
+}
+
+// Drop queued edges, restart from current pin level. To
+// be called while the button is not evaluated by scan().
+void SIDButton::flush()
+{
+    if(!_useISR)
+        return;
+        
+    _qTail = _qHead;
+    _qOverflow = false;
+    _active = (digitalRead(_pin) == _buttonPressed);
+    reset();
+    _startTime = micros();
+}
+
+// micros() of the edge that lead to the last press/long press event
+unsigned long SIDButton::getEventTime()
+{
+    return _eventTime;
+}
+
+void IRAM_ATTR SIDButton::edgeISR(void *arg)
+{
+    SIDButton *b = (SIDButton *)arg;
+    uint8_t next = (b->_qHead + 1) % BTN_QUEUESIZE;
+
+    if(next != b->_qTail) {
+        b->_qTime[b->_qHead] = micros();
+        b->_qActive[b->_qHead] = (digitalRead(b->_pin) == b->_buttonPressed);
+        b->_qHead = next;
+    } else {
+        b->_qOverflow = true;
+    }
+
+    if(b->_wakeFunc) b->_wakeFunc();
+}
+
 // Number of millisec that have to pass by before a click is assumed stable.
 void SIDButton::setDebounceTicks(const int ticks)
 {
@@ -277,9 +808,32 @@ void SIDButton::attachLongPressStop(void (*newFunction)(void))
 // Check input of the pin and advance the state machine
 void SIDButton::scan(void)
 {
-    unsigned long now = millis();
-    unsigned long waitTime = now - _startTime;
-    bool active = (digitalRead(_pin) == _buttonPressed);
+    if(!_useISR) {
+        advance(micros(), (digitalRead(_pin) == _buttonPressed));
+        return;
+    }
+
+    // Lost edges: Restart from current level
+    if(_qOverflow) {
+        flush();
+    }
+
+    while(_qTail != _qHead) {
+        unsigned long t = _qTime[_qTail];
+        // Timeouts up to the edge, then the edge itself
+        advance(t, _active);
+        _active = _qActive[_qTail];
+        advance(t, _active);
+        _qTail = (_qTail + 1) % BTN_QUEUESIZE;
+    }
+
+    advance(micros(), _active);
+}
+
+// State machine; now in us, active: pin level at that time
+void SIDButton::advance(unsigned long now, bool active)
+{
+    unsigned long waitTime = (now - _startTime) / 1000;
     
     switch(_state) {
     case TCBS_IDLE:
@@ -297,11 +851,13 @@ void SIDButton::scan(void)
             _startTime = now;
         } else if(active) {
             if(!_longPressStartFunc) {
-                if(waitTime > _pressTicks) {
+                if(!_pressNotified && waitTime > _pressTicks) {
+                    _eventTime = _startTime;
                     if(_pressFunc) _pressFunc();
                     _pressNotified = true;
                 }      
             } else if(waitTime > _longPressTicks) {
+                _eventTime = _startTime;
                 if(_longPressStartFunc) _longPressStartFunc(); 
                 transitionTo(TCBS_LONGPRESS);
             }
@@ -312,6 +868,7 @@ void SIDButton::scan(void)
         if((active) && (waitTime < _debounceTicks)) {  // de-bounce
             transitionTo(_lastState);
         } else if((!active) && (waitTime > _pressTicks)) {
+            _eventTime = _startTime;
             if(!_pressNotified && _pressFunc) _pressFunc();
             reset();
         }
@@ -37,38 +37,75 @@
  * IRRemote class
  */
 
-#define IRBUFSIZE 100
+#define IRBUFSIZE   100
+#define IRQUEUESIZE 8     // Queue holds IRQUEUESIZE-1 transmissions
+
+typedef enum {
+    IRPROTO_UNKNOWN,    // Identified by hash only
+    IRPROTO_NEC,
+    IRPROTO_SIRC,
+    IRPROTO_RC5,
+    IRPROTO_RC6
+} IRProtocol;
+
+typedef struct {
+    uint8_t  protocol;
+    bool     repeat;
+    uint16_t address;
+    uint16_t command;
+} IRCode;
 
 typedef enum {
     IRSTATE_IDLE,
     IRSTATE_LIGHT,
-    IRSTATE_DARK,
-    IRSTATE_STOP  
+    IRSTATE_DARK
 } IRState;
 
 class IRRemote {
 
     public:
-        IRRemote(uint8_t timerno, uint8_t ir_pin);
+        IRRemote(uint8_t ir_pin);
         void begin();
 
         bool loop();
         uint32_t readHash();
+        const IRCode& readCode();
+        unsigned long readTime();
+        unsigned long readEndTime();
+        const uint32_t *readDurations(uint32_t &len);
         void resume();
+
+        uint32_t getOverflow();
+
+        void setWakeup(void (*isrFunc)());
+
+        static uint32_t hashDurations(const uint32_t *buf, uint32_t len);
         
     private:
-        uint32_t compare(unsigned int oldval, unsigned int newval);
+        static uint32_t compare(uint32_t a, uint32_t b);
         bool     calcHash();
 
-        uint8_t _timer_no = 0;
-        hw_timer_t *_IRTimer = NULL;
+        bool     decode();
+        void     codeHash();
+        bool     decodeNEC();
+        bool     decodeSIRC();
+        bool     decodeRC5();
+        bool     decodeRC6();
+        int      toSlots(int first, uint32_t unit, uint8_t *slots, int maxSlots);
+        #ifdef SID_IR_DUMP
+        void     dumpFrame(bool valid);
+        #endif
 
         uint32_t _buflen;
         uint32_t _buf[IRBUFSIZE];
         uint32_t _hvalue;
+        unsigned long _time;
+        unsigned long _endTime;
+        IRCode   _code = { IRPROTO_UNKNOWN, false, 0, 0 };
+        uint8_t  _toggle = 0;
 
-        unsigned long _prevTime;
-        uint32_t      _prevHash;
+        unsigned long _prevTime = 0;
+        uint32_t      _prevHash = 0;
 };
 
 
@@ -76,6 +113,8 @@ class IRRemote {
  * SIDButton class
  */
 
+#define BTN_QUEUESIZE 16
+
 typedef enum {
     TCBS_IDLE,
     TCBS_PRESSED,
@@ -88,6 +127,8 @@ class SIDButton {
   
     public:
         SIDButton(const int pin, const boolean activeLow = true, const bool pullupActive = true);
+        void begin();
+        void setWakeup(void (*isrFunc)());
       
         void setDebounceTicks(const int ticks);
         void setPressTicks(const int ticks);
@@ -98,11 +139,17 @@ class SIDButton {
         void attachLongPressStop(void (*newFunction)(void));
 
         void scan(void);
+        void flush();
+
+        unsigned long getEventTime();
 
     private:
 
         void reset(void);
         void transitionTo(ButtonState nextState);
+        void advance(unsigned long now, bool active);
+
+        static void edgeISR(void *arg);
 
         void (*_pressFunc)(void) = NULL;
         void (*_longPressStartFunc)(void) = NULL;
@@ -122,6 +169,18 @@ class SIDButton {
         unsigned long _startTime;
 
         bool _pressNotified = false;
+
+        unsigned long _eventTime = 0;
+
+        // Edge queue (ISR -> scan())
+        bool _useISR = false;
+        bool _active = false;
+        void (* volatile _wakeFunc)() = NULL;
+        volatile unsigned long _qTime[BTN_QUEUESIZE];
+        volatile bool    _qActive[BTN_QUEUESIZE];
+        volatile uint8_t _qHead = 0;
+        volatile uint8_t _qTail = 0;
+        volatile bool    _qOverflow = false;
 };
 
 #endif
@@ -83,6 +83,75 @@
 
 /*  Changelog
  *  
+ *  2026/10/18
+ *    - Display: Add temporal dithering mode (SID_DITHER in sid_global.h); display
+ *      is refreshed 2-4 times per frame by a timer-driven task, which allows for
+ *      dimmed LEDs. SA peaks are shown dimmed in this mode.
+ *    - Add frame clock: Time travel, idle patterns, SA and games are now drawn
+ *      by frame callbacks at a fixed rate; display is pushed once per frame.
+ *      Missed frames are counted (and logged in debug mode).
+ *    - Add virtual display (SID_VDISPLAY in sid_global.h) for debugging: i2c
+ *      traffic is decoded by a HT16K33 model; prints bus load, frame rate and
+ *      show() timing, optionally dumps changed frames as ASCII art.
+ *    - Fonts are now stored as column masks, plus ASCII lookup tables; letters
+ *      are ORed into the display buffer column by column. Fixes clipping of
+ *      letters at negative offsets.
+ *    - Add text engine: Word sequences ("GAME OVER", "ALARM", IP address etc)
+ *      no longer block the main loop; text jobs are queued and run by the 
+ *      frame clock. Also supports pixel-wise scrolling. A time travel aborts
+ *      any text being displayed.
+ *    - Display: Number of chips and matrix geometry are now compile-time
+ *      parameters (siddisplay.h), wiring is described per bar. All drawing
+ *      is done on column masks instead of per LED.
+ *    - Display: Add brightness animator (fades with easing, driven by frame
+ *      clock). Used for word sequences, the screen saver (fades out/in) and
+ *      the time travel flicker. Dimming is only sent to chips when changed.
+ *    - Add scheduler for timed tasks; startup sequence and boot-time IR feedback
+ *      no longer block the main loop. mydelay() is gone. Max main loop latency
+ *      is logged in debug mode.
+ *    - Main loop sleeps until next deadline (frame, task; max 10ms) instead
+ *      of busy polling; IR and TT button wake it up. Idle percentage is
+ *      logged in debug mode.
+ *    - Animations use a fast seedable PRNG instead of the hardware RNG; a
+ *      fixed seed (SID_RAND_SEED) makes random sequences reproducible.
+ *    - TT sequence driven by a phase table; identical timing for TCD-triggered
+ *      and stand-alone time travels.
+ *    - Add idle patterns 6-9: Custom animations streamed from SD/flash
+ *      (idle6.sda-idle9.sda), selected by *16OK-*19OK.
+ *    - Idle patterns 0-3: Smooth transitions between bar heights, drawn at
+ *      the frame rate.
+ *    - Record Spectrum Analyzer output to SD as idle pattern 6-9 (*26OK-*29OK);
+ *      plays back without mic.
+ *    - Idle modes are kept in a registry of generators; MQTT IDLE_n accepts
+ *      all modes.
+ *    - Time travel latency statistics: Timestamp trigger (TT pin edge,
+ *      BTTFN packet, MQTT message), pick-up in main loop, start of time
+ *      travel and first display update; keep last 16 samples per source.
+ *      Printed in debug mode, published on MQTT command "LATENCY".
+ *    - IR receiver: Time marks/spaces by pin change interrupt and micros()
+ *      instead of sampling the pin every 50us from a timer interrupt.
+ *    - IR receiver: Queue up to 7 received codes, so that key presses are
+ *      not lost while the main loop is busy.
+ *    - IR receiver: Decode NEC, Sony SIRC, RC5 and RC6 codes; repeated
+ *      frames (held keys, SIRC sending each code three times) no longer
+ *      count as separate key presses. RC5/RC6 keys give the same code
+ *      regardless of the toggle bit; such keys need to be learned again.
+ *    - IR: Look up received codes in a hash map instead of scanning the
+ *      code table; received codes only logged in debug mode.
+ *    - IR: Auto-repeat of held keys (Siddly moves, brightness) on remotes
+ *      that send repeat frames.
+ *    - TT button/TCD trigger: Edges caught by interrupt and timestamped;
+ *      debounce and press detection work on the exact edge times.
+ *    - Debug option SID_IR_DUMP: Print received IR traces and robustness
+ *      of the hash against timing jitter.
+ *    - Host tests (test/): Replay IR traces, measure hash throughput,
+ *      collisions and jitter tolerance. Draw display scenes through the
+ *      HT16K33 model, compare against golden frames, measure show() for
+ *      2, 4 and 8 chips. Benchmark Siddly collision tests, moves and the
+ *      demo player's search; play demo games. Run the time travel sequence
+ *      for all trigger sources with a simulated clock.
+ *    - Siddly: Board kept as row bit masks, pieces pre-rotated.
+ *    - Siddly: Demo mode (*24), computer player with one-piece lookahead.
  *  2023/11/05 (A10001986)
  *    - Settings: Write JSON to buffer before file
  *    - Fix corrupt CfgOnSD setting
@@ -244,6 +313,7 @@
 #include "sid_settings.h"
 #include "sid_wifi.h"
 #include "sid_main.h"
+#include "sid_sched.h"
 
 void setup()
 {
@@ -266,4 +336,5 @@ void loop()
     main_loop();
     wifi_loop();
     bttfn_loop();
+    sched_sleep();
 }
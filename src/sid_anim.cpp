@@ -0,0 +1,302 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Animation player: Idle animations from SD/flash
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "sid_anim.h"
+#include "sid_main.h"
+#include "sid_settings.h"
+
+/*
+ * Plays bar animations from files on SD (or flash FS) as additional
+ * idle modes. Idle mode N reads "/idleN.sda". The file is streamed
+ * through a small read-ahead buffer, it is never loaded as a whole.
+ * 
+ * File format (all multi-byte values little endian):
+ * 
+ * Header (8 bytes):
+ *   'S' 'I' 'D' 'A'   Magic
+ *   version           ANIM_VERSION
+ *   bars              Number of bars (1-10)
+ *   loop (2 bytes)    Frame number to continue with after the last 
+ *                     frame; 0xffff: no loop, last frame is held
+ * 
+ * Frames: 
+ *   type              ANIM_xxx
+ *   duration          Frame duration in 10ms units (not for ANIM_END)
+ *   payload:
+ *     ANIM_KEY:       Run-length encoded bar heights: Pairs of
+ *                     (count, height) until all bars are covered
+ *     ANIM_DELTA:     Mask of changed bars (2 bytes, bit 0 = bar 0),
+ *                     followed by one height per set bit
+ *     ANIM_HOLD:      None, previous frame is shown for duration
+ *     ANIM_PACKED:    All heights, 5 bits each, bar 0 in the lowest
+ *                     bits of the first byte (ANIM_PACKED_SIZE bytes)
+ *     ANIM_END:       None, end of animation
+ * 
+ * Heights are 0 (bar off) to 20 (bar fully lit).
+ */
+
+static File          animFile;
+static bool          animActive = false;
+
+static uint8_t       animBuf[ANIM_BUF_SIZE];
+static uint16_t      animBufLen = 0;
+static uint16_t      animBufIdx = 0;
+static uint32_t      animBufPos = 0;    // File position of animBuf[0]
+
+static uint8_t       animBars = 0;
+static uint16_t      animLoop = ANIM_NO_LOOP;
+static uint16_t      animFrameNo = 0;
+static uint32_t      animLoopPos = ANIM_HDR_SIZE;
+
+static uint8_t       animHeights[ANIM_MAX_BARS];
+static uint8_t       animLoopHeights[ANIM_MAX_BARS];
+
+static unsigned long animLastFrame = 0;
+static unsigned long animFrameDur = 0;
+static bool          animHold = false;
+
+static bool animSeek(uint32_t pos)
+{
+    animBufLen = animBufIdx = 0;
+    animBufPos = pos;
+    
+    return animFile.seek(pos);
+}
+
+static int animRead()
+{
+    if(animBufIdx >= animBufLen) {
+        animBufPos += animBufLen;
+        animBufIdx = 0;
+        animBufLen = animFile.read(animBuf, ANIM_BUF_SIZE);
+        if(!animBufLen) 
+            return -1;
+    }
+    
+    return animBuf[animBufIdx++];
+}
+
+static int animRead16()
+{
+    int lo = animRead();
+    int hi = animRead();
+
+    if(lo < 0 || hi < 0)
+        return -1;
+
+    return lo | (hi << 8);
+}
+
+bool anim_start(int num)
+{
+    char fn[16];
+    uint8_t hdr[ANIM_HDR_SIZE];
+
+    anim_stop();
+
+    sprintf(fn, "/idle%d.sda", num);
+
+    if(!openDataFileRead(fn, animFile)) {
+        #ifdef SID_DBG
+        Serial.printf("anim: %s not found\n", fn);
+        #endif
+        return false;
+    }
+
+    if(animFile.read(hdr, ANIM_HDR_SIZE) != ANIM_HDR_SIZE ||
+       memcmp(hdr, "SIDA", 4)                             ||
+       hdr[4] != ANIM_VERSION                             ||
+       !hdr[5] || hdr[5] > ANIM_MAX_BARS) {
+        #ifdef SID_DBG
+        Serial.printf("anim: %s: Bad header\n", fn);
+        #endif
+        animFile.close();
+        return false;
+    }
+
+    animBars = hdr[5];
+    animLoop = hdr[6] | (hdr[7] << 8);
+    
+    animBufLen = animBufIdx = 0;
+    animBufPos = animLoopPos = ANIM_HDR_SIZE;
+    animFrameNo = 0;
+    memset(animHeights, 0, sizeof(animHeights));
+
+    animFrameDur = 0;
+    animHold = false;
+    animActive = true;
+
+    #ifdef SID_DBG
+    Serial.printf("anim: Playing %s (%d bars, loop %d)\n", fn, animBars, animLoop);
+    #endif
+
+    return true;
+}
+
+void anim_stop()
+{
+    if(animActive) {
+        animFile.close();
+        animActive = false;
+    }
+}
+
+bool anim_isActive()
+{
+    return animActive;
+}
+
+/*
+ * Decode next frame into animHeights.
+ * Returns 1 if frame was decoded, 0 at end of animation,
+ * -1 on error.
+ */
+static int animDecode()
+{
+    int type, dur, c, h, mask;
+
+    // Remember state at loop point; delta frames 
+    // depend on the previous frame
+    if(animFrameNo == animLoop) {
+        animLoopPos = animBufPos + animBufIdx;
+        memcpy(animLoopHeights, animHeights, sizeof(animHeights));
+    }
+
+    if((type = animRead()) <= ANIM_END) 
+        return animFrameNo ? 0 : -1;     // No frames at all: Error
+
+    if((dur = animRead()) < 0)
+        return -1;
+
+    switch(type) {
+    case ANIM_KEY:
+        for(int i = 0; i < animBars; ) {
+            if((c = animRead()) <= 0 || (h = animRead()) < 0)
+                return -1;
+            if(h > SD_ROWS) h = SD_ROWS;
+            while(c-- && i < animBars) {
+                animHeights[i++] = h;
+            }
+        }
+        break;
+    case ANIM_DELTA:
+        if((mask = animRead16()) < 0)
+            return -1;
+        for(int i = 0; i < animBars; i++, mask >>= 1) {
+            if(mask & 1) {
+                if((h = animRead()) < 0)
+                    return -1;
+                animHeights[i] = (h > SD_ROWS) ? SD_ROWS : h;
+            }
+        }
+        break;
+    case ANIM_HOLD:
+        break;
+    case ANIM_PACKED:
+        {
+            uint32_t bits = 0;
+            int nbits = 0;
+            for(int i = 0; i < animBars; i++) {
+                if(nbits < 5) {
+                    if((h = animRead()) < 0)
+                        return -1;
+                    bits |= (uint32_t)h << nbits;
+                    nbits += 8;
+                }
+                h = bits & 0x1f;
+                animHeights[i] = (h > SD_ROWS) ? SD_ROWS : h;
+                bits >>= 5;
+                nbits -= 5;
+            }
+        }
+        break;
+    default:
+        return -1;
+    }
+
+    animFrameDur = dur * 10;
+    animFrameNo++;
+
+    return 1;
+}
+
+/*
+ * Render next frame if due. Called for every frame clock tick
+ * while an animation idle mode is active.
+ * Returns true if a new frame was drawn.
+ */
+bool anim_frame(unsigned long now)
+{
+    int ret = 1;
+
+    if(!animActive)
+        return false;
+
+    if(now - animLastFrame < animFrameDur)
+        return false;
+
+    if(!animHold && !(ret = animDecode())) {
+        if(animLoop == ANIM_NO_LOOP || animLoop >= animFrameNo) {
+            // No (valid) loop point: Hold last frame; redraw 
+            // it once in a while (in case of a TT in between)
+            animHold = true;
+            animFrameDur = 1000;
+            ret = 1;
+        } else {
+            animSeek(animLoopPos);
+            memcpy(animHeights, animLoopHeights, sizeof(animHeights));
+            animFrameNo = animLoop;
+            ret = animDecode();
+        }
+    }
+
+    if(ret <= 0) {
+        #ifdef SID_DBG
+        Serial.printf("anim: Bad frame %d\n", animFrameNo);
+        #endif
+        anim_stop();
+        return false;
+    }
+
+    animLastFrame = now;
+
+    for(int i = 0; i < animBars; i++) {
+        sid.drawBarWithHeight(i, animHeights[i]);
+    }
+
+    return true;
+}
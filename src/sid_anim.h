@@ -0,0 +1,60 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Animation player: Idle animations from SD/flash
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SID_ANIM_H
+#define _SID_ANIM_H
+
+#include "siddisplay.h"
+
+#define ANIM_BUF_SIZE   64    // Read-ahead buffer size
+
+// File format, see sid_anim.cpp
+#define ANIM_VERSION    1
+#define ANIM_HDR_SIZE   8
+#define ANIM_NO_LOOP    0xffff
+#define ANIM_MAX_BARS   SD_BARS
+
+#define ANIM_END        0     // Frame types
+#define ANIM_KEY        1
+#define ANIM_DELTA      2
+#define ANIM_HOLD       3
+#define ANIM_PACKED     4
+
+#define ANIM_PACKED_SIZE(bars) (((bars) * 5 + 7) / 8)
+
+bool anim_start(int num);
+void anim_stop();
+bool anim_isActive();
+
+bool anim_frame(unsigned long now);
+
+#endif
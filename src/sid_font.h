@@ -34,9 +34,29 @@
 #ifndef _SID_FONT_H
 #define _SID_FONT_H
 
-static const uint16_t alphaChars[36+1+1+7][10] = 
+/*
+ * Fonts are stored as column masks, one entry per column (left to 
+ * right), MSB = top row. They can be shifted and ORed into the
+ * display buffer (one word per bar) directly.
+ * glyphIdx/glyphIdx8 map ASCII to glyph index (0xff = no glyph)
+ */
+
+// 10x10 font
+static const uint8_t glyphIdx[128] = 
 {
-  {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   // 0x00
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   // 0x10
+    0xff, 0xff, 0xff,   39,   41, 0xff,   37, 0xff, 0xff, 0xff,   38, 0xff, 0xff, 0xff,   36, 0xff,   // 0x20
+       0,    1,    2,    3,    4,    5,    6,    7,    8,    9, 0xff, 0xff,   42, 0xff,   43, 0xff,   // 0x30
+    0xff,   10,   11,   12,   13,   14,   15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   // 0x40
+      25,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35, 0xff, 0xff, 0xff,   40, 0xff,   // 0x50
+    0xff,   10,   11,   12,   13,   14,   15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   // 0x60
+      25,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35, 0xff, 0xff, 0xff,   44, 0xff   // 0x70
+};
+
+static const uint16_t alphaCols[45][10] = 
+{
+  {   // '0'
     0b0011111100,
     0b0111111110,
     0b1110000111,
@@ -48,200 +68,212 @@ static const uint16_t alphaChars[36+1+1+7][10] =
     0b0111111110,
     0b0011111100
   },
-  {
-    0b0000110000,
-    0b0001110000,
-    0b0011110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0011111100,
-    0b0011111100
-  },
-  {
-    0b1111111100,
-    0b1111111110,
-    0b0000000111,
-    0b0000000111,
-    0b0011111110,
-    0b0111111100,
-    0b1110000000,
-    0b1100000000,
-    0b1111111111,
-    0b1111111111
-  },
-  {
-    0b1111111100,
-    0b1111111110,
-    0b0000000111,
-    0b0000000111,
-    0b0001111110,
-    0b0001111110,
-    0b0000000111,
-    0b0000000111,
-    0b1111111110,
-    0b1111111100
-  },
-  {
-    0b0000011111,
-    0b0000111111,
-    0b0001110011,
-    0b0011100011,
-    0b0111000011,
+  {   // '1'
+    0b0000000000,
+    0b0000000000,
+    0b0010000011,
+    0b0110000011,
     0b1111111111,
     0b1111111111,
     0b0000000011,
     0b0000000011,
-    0b0000000011
+    0b0000000000,
+    0b0000000000
   },
-  {
-    0b1111111110,
-    0b1111111110,
-    0b1100000000,
-    0b1100000000,
-    0b1111111100,
-    0b1111111110,
-    0b0000000111,
-    0b0000000111,
-    0b1111111110,
-    0b1111111100
+  {   // '2'
+    0b1100001111,
+    0b1100011111,
+    0b1100111011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1111110011,
+    0b0111100011,
+    0b0011000011
   },
-  {
-    0b0011111110,
-    0b0111111110,
-    0b1110000000,
-    0b1100000000,
-    0b1111111100,
-    0b1111111110,
-    0b1100000111,
-    0b1110000111,
+  {   // '3'
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1111111111,
     0b0111111110,
-    0b0011111100
+    0b0011001100
   },
-  {
-    0b1111111111,
-    0b1111111111,
-    0b0000000011,
-    0b0000000111,
-    0b0000001110,
-    0b0000011100,
+  {   // '4'
+    0b0000011000,
     0b0000111000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000
+    0b0001111000,
+    0b0011111000,
+    0b0111011000,
+    0b1110011000,
+    0b1100011000,
+    0b1100011000,
+    0b1111111111,
+    0b1111111111
+  },
+  {   // '5'
+    0b1111110011,
+    0b1111110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100111111,
+    0b1100011110,
+    0b0000001100
   },
-  {
+  {   // '6'
     0b0011111100,
     0b0111111110,
-    0b1100000011,
-    0b1100000011,
+    0b1110110111,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100111111,
+    0b1100011110,
+    0b0000001100
+  },
+  {   // '7'
+    0b1100000000,
+    0b1100000000,
+    0b1100000000,
+    0b1100000000,
+    0b1100001111,
+    0b1100011111,
+    0b1100111000,
+    0b1101110000,
+    0b1111100000,
+    0b1111000000
+  },
+  {   // '8'
+    0b0011001100,
     0b0111111110,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
     0b0111111110,
-    0b1100000011,
-    0b1100000011,
+    0b0011001100
+  },
+  {   // '9'
+    0b0011000000,
+    0b0111110010,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
     0b0111111110,
     0b0011111100
   },
-  {
-    0b0011111100,
-    0b0111111110,
-    0b1100000011,
-    0b1100000011,
+  {   // 'A'
+    0b0011111111,
     0b0111111111,
+    0b1110011000,
+    0b1100011000,
+    0b1100011000,
+    0b1100011000,
+    0b1100011000,
+    0b1110011000,
     0b0111111111,
-    0b0000000011,
-    0b0000000011,
-    0b0111111110,
-    0b0011111100    
+    0b0011111111
+  },
+  {   // 'B'
+    0b1111111111,
+    0b1111111111,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1111111111,
+    0b0111001110,
+    0b0011001100
   },
-  {
+  {   // 'C'
     0b0011111100,
     0b0111111110,
     0b1110000111,
     0b1100000011,
     0b1100000011,
-    0b1111111111,
-    0b1111111111,
     0b1100000011,
     0b1100000011,
-    0b1100000011    
-  },
-  {
-    0b1111111100,
-    0b1111111110,
-    0b1100000111,
-    0b1100000111,
-    0b1111111100,
-    0b1111111100,
-    0b1100000111,
-    0b1100000111,
-    0b1111111110,
-    0b1111111100
-  },
-  {
-    0b0011111100,
-    0b0111111110,
-    0b1110000111,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
     0b1110000111,
-    0b0111111110,
-    0b0011111100
+    0b0110000110,
+    0b0010000100
   },
-  {
-    0b1111111100,
-    0b1111111110,
-    0b1100000111,
+  {   // 'D'
+    0b1111111111,
+    0b1111111111,
     0b1100000011,
     0b1100000011,
     0b1100000011,
     0b1100000011,
-    0b1100000111,
-    0b1111111110,
-    0b1111111100
+    0b1100000011,
+    0b1110000111,
+    0b0111111110,
+    0b0011111100
   },
-  {
-    0b1111111111,
-    0b1111111111,
-    0b1100000000,
-    0b1100000000,
-    0b1111110000,
-    0b1111110000,
-    0b1100000000,
-    0b1100000000,
+  {   // 'E'
     0b1111111111,
     0b1111111111,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011
   },
-  {
+  {   // 'F'
     0b1111111111,
     0b1111111111,
-    0b1100000000,
-    0b1100000000,
-    0b1111110000,
-    0b1111110000,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
     0b1100000000,
     0b1100000000,
     0b1100000000,
     0b1100000000
   },
-  {
-    0b0011111110,
-    0b0111111111,
-    0b1110000011,
-    0b1100000000,
-    0b1100111111,
-    0b1100111111,
+  {   // 'G'
+    0b0011111100,
+    0b0111111110,
+    0b1110000111,
     0b1100000011,
-    0b1110000011,
-    0b0111111111,
-    0b0011111111
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1110111111,
+    0b0110111111
   },
-  {
-    0b1100000011,
+  {   // 'H'
+    0b1111111111,
+    0b1111111111,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b1111111111,
+    0b1111111111
+  },
+  {   // 'I'
+    0b0000000000,
     0b1100000011,
     0b1100000011,
     0b1100000011,
@@ -250,81 +282,69 @@ static const uint16_t alphaChars[36+1+1+7][10] =
     0b1100000011,
     0b1100000011,
     0b1100000011,
-    0b1100000011
+    0b0000000000
   },
-  {
-    0b0111111110,
-    0b0111111110,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
+  {   // 'J'
+    0b0000001100,
+    0b0000001110,
+    0b1100000111,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100000111,
+    0b1111111110,
+    0b1111111100
+  },
+  {   // 'K'
+    0b1111111111,
+    0b1111111111,
     0b0000110000,
     0b0000110000,
-    0b0111111110,
-    0b0111111110 
+    0b0001111000,
+    0b0011111100,
+    0b0111001110,
+    0b1110000111,
+    0b1100000011,
+    0b1000000001
   },
-  {
-    0b0011111111,
-    0b0011111111,
+  {   // 'L'
+    0b1111111111,
+    0b1111111111,
     0b0000000011,
     0b0000000011,
     0b0000000011,
     0b0000000011,
-    0b1100000011,
-    0b1110000111,
-    0b0111111110,
-    0b0011111100
-  },
-  {
-    0b1100000111,
-    0b1100001110,
-    0b1100011100,
-    0b1100111000,
-    0b1111110000,
-    0b1111110000,
-    0b1100111000,
-    0b1100011100,
-    0b1100001110,
-    0b1100000111
+    0b0000000011,
+    0b0000000011,
+    0b0000000011,
+    0b0000000011
   },
-  {
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
+  {   // 'M'
+    0b1111111111,
+    0b1111111111,
+    0b0111000000,
+    0b0011100000,
+    0b0001110000,
+    0b0001110000,
+    0b0011100000,
+    0b0111000000,
     0b1111111111,
     0b1111111111
   },
-  {
-    0b1100000011,
-    0b1110000111,
-    0b1111001111,
+  {   // 'N'
     0b1111111111,
-    0b1101111011,
-    0b1100110011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011
-  },
-  {
-    0b1100000011,
-    0b1110000011,
-    0b1111000011,
-    0b1111100011,
-    0b1101110011,
-    0b1100111011,
-    0b1100011111,
-    0b1100001111,
-    0b1100000111,
-    0b1100000011
+    0b1111111111,
+    0b0111000000,
+    0b0011100000,
+    0b0001110000,
+    0b0000111000,
+    0b0000011100,
+    0b0000001110,
+    0b1111111111,
+    0b1111111111
   },
-  {
+  {   // 'O'
     0b0011111100,
     0b0111111110,
     0b1110000111,
@@ -336,103 +356,103 @@ static const uint16_t alphaChars[36+1+1+7][10] =
     0b0111111110,
     0b0011111100
   },
-  {
-    0b1111111100,
-    0b1111111110,
-    0b1100000111,
-    0b1100000111,
-    0b1111111110,
-    0b1111111100,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000,
-    0b1100000000
+  {   // 'P'
+    0b1111111111,
+    0b1111111111,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
+    0b1111110000,
+    0b0111100000,
+    0b0011000000
   },
-  {
+  {   // 'Q'
     0b0011111100,
     0b0111111110,
     0b1110000111,
     0b1100000011,
     0b1100000011,
     0b1100000111,
-    0b1100001110,
-    0b1110011100,
+    0b1100001111,
+    0b1110011111,
+    0b0111111011,
+    0b0011110011
+  },
+  {   // 'R'
+    0b1111111111,
+    0b1111111111,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
+    0b1100110000,
+    0b1100111000,
+    0b1111111100,
     0b0111111111,
-    0b0011111111
+    0b0011000111
   },
-  {
+  {   // 'S'
+    0b0011000011,
+    0b0111100011,
+    0b1111110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100110011,
+    0b1100111111,
+    0b1100011110,
+    0b1100001100
+  },
+  {   // 'T'
+    0b1100000000,
+    0b1100000000,
+    0b1100000000,
+    0b1100000000,
+    0b1111111111,
+    0b1111111111,
+    0b1100000000,
+    0b1100000000,
+    0b1100000000,
+    0b1100000000
+  },
+  {   // 'U'
     0b1111111100,
     0b1111111110,
-    0b1100000111,
-    0b1100000111,
-    0b1111111110,
-    0b1111111110,
-    0b1100001110,
-    0b1100000111,
-    0b1100000011,
-    0b1100000011
-  },
-  {
-    0b0011111111,
-    0b0111111111,
-    0b1110000000,
-    0b1110000000,
-    0b0111111100,
-    0b0011111110,
     0b0000000111,
+    0b0000000011,
+    0b0000000001,
+    0b0000000001,
+    0b0000000011,
     0b0000000111,
     0b1111111110,
     0b1111111100
   },
-  {
-    0b1111111111,
-    0b1111111111,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000
-  },
-  {
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1110000111,
-    0b0111001110,
-    0b0011111100
-  },
-  {
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1110000111,
-    0b0111001110,
-    0b0011111100,
-    0b0001111000,
-    0b0000110000
+  {   // 'V'
+    0b1111110000,
+    0b1111111000,
+    0b0000011100,
+    0b0000001110,
+    0b0000000111,
+    0b0000000111,
+    0b0000001110,
+    0b0000011100,
+    0b1111111000,
+    0b1111110000
   },
-  {
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100000011,
-    0b1100110011,
-    0b1101111011,
+  {   // 'W'
     0b1111111111,
-    0b1111001111,
-    0b1110000111,
-    0b1100000011
+    0b1111111111,
+    0b0000001110,
+    0b0000011100,
+    0b0000111000,
+    0b0000111000,
+    0b0000011100,
+    0b0000001110,
+    0b1111111111,
+    0b1111111111
   },
-  {
+  {   // 'X'
     0b1100000011,
     0b1110000111,
     0b0111001110,
@@ -444,143 +464,157 @@ static const uint16_t alphaChars[36+1+1+7][10] =
     0b1110000111,
     0b1100000011
   },
-  {
-    0b1100000011,
-    0b1110000111,
-    0b0111001110,
-    0b0011111100,
-    0b0001111000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000,
-    0b0000110000
-  },
-  {
-    0b1111111111,
-    0b1111111111,
-    0b0000001110,
-    0b0000011100,
-    0b0000111000,
-    0b0001110000,
+  {   // 'Y'
+    0b1100000000,
+    0b1110000000,
+    0b0111000000,
+    0b0011100000,
+    0b0001111111,
+    0b0001111111,
     0b0011100000,
     0b0111000000,
-    0b1111111111,
-    0b1111111111
+    0b1110000000,
+    0b1100000000
   },
-  {
-    0b0000000000,
+  {   // 'Z'
+    0b1100000011,
+    0b1100000111,
+    0b1100001111,
+    0b1100011111,
+    0b1100111011,
+    0b1101110011,
+    0b1111100011,
+    0b1111000011,
+    0b1110000011,
+    0b1100000011
+  },
+  {   // '.'
     0b0000000000,
     0b0000000000,
     0b0000000000,
     0b0000000000,
+    0b0000000011,
+    0b0000000011,
     0b0000000000,
     0b0000000000,
     0b0000000000,
-    0b0000110000,
-    0b0000110000
+    0b0000000000
+  },
+  {   // '&'
+    0b1000000010,
+    0b1100000110,
+    0b1110001110,
+    0b1011011010,
+    0b1001110010,
+    0b1001110010,
+    0b1011011010,
+    0b1110001110,
+    0b1100000110,
+    0b1000000010
+  },
+  {   // '*'
+    0b0000100000,
+    0b0100100100,
+    0b0110101100,
+    0b0011111000,
+    0b0001110000,
+    0b0001110000,
+    0b0011111000,
+    0b0110101100,
+    0b0100100100,
+    0b0000100000
   },
-  {                   // 37
+  {   // '#'
+    0b0001001000,
+    0b0001001000,
     0b1111111111,
-    0b0110000110,
-    0b0011001100,
-    0b0001111000,
-    0b0000110000,
-    0b0001111000,
-    0b0011001100,
-    0b0110000110,
     0b1111111111,
-    0b0000000000
+    0b0001001000,
+    0b0001001000,
+    0b1111111111,
+    0b1111111111,
+    0b0001001000,
+    0b0001001000
   },
-  {
+  {   // '^'
     0b0000000000,
-    0b0110000110,
-    0b0011001100,
-    0b0001111000,
+    0b0001000000,
+    0b0011000000,
+    0b0111000000,
     0b1111111111,
-    0b0001111000,
-    0b0011001100,
-    0b0110000110,
-    0b0000000000,
+    0b1111111111,
+    0b0111000000,
+    0b0011000000,
+    0b0001000000,
     0b0000000000
   },
-  {
-    0b0011001100,
-    0b0011001100,
-    0b0011001100,
+  {   // '$'
+    0b0000000000,
+    0b0000001000,
+    0b0000001100,
+    0b0000001110,
     0b1111111111,
-    0b0011001100,
-    0b0011001100,
     0b1111111111,
-    0b0011001100,
-    0b0011001100,
-    0b0011001100
+    0b0000001110,
+    0b0000001100,
+    0b0000001000,
+    0b0000000000
   },
-  {
+  {   // '<'
     0b0000110000,
     0b0001111000,
     0b0011111100,
     0b0111111110,
-    0b0000110000,
+    0b1111111111,
     0b0000110000,
     0b0000110000,
     0b0000110000,
     0b0000110000,
     0b0000110000
   },
-  {
-    0b0000110000,
+  {   // '>'
     0b0000110000,
     0b0000110000,
     0b0000110000,
     0b0000110000,
     0b0000110000,
+    0b1111111111,
     0b0111111110,
     0b0011111100,
     0b0001111000,
     0b0000110000
   },
-  {
-    0b0000100000,
-    0b0001100000,
-    0b0011100000,
-    0b0111100000,
-    0b1111111111,
-    0b1111111111,
-    0b0111100000,
-    0b0011100000,
-    0b0001100000,
-    0b0000100000
-  },
-  {
-    0b0000010000,
-    0b0000011000,
-    0b0000011100,
-    0b0000011110,
-    0b1111111111,
-    0b1111111111,
-    0b0000011110,
-    0b0000011100,
-    0b0000011000,
-    0b0000010000
-  },  
-  {
-    0b0000000000,
-    0b0000000000,
-    0b0110010001,
-    0b1001010010,
-    0b1001011100,
-    0b1001010010,
-    0b0110010001,
-    0b0000000000,
+  {   // '~'
+    0b0001110000,
+    0b0010001000,
+    0b0010001000,
+    0b0001110000,
     0b0000000000,
-    0b0000000000
+    0b0011111000,
+    0b0000100000,
+    0b0000100000,
+    0b0001010000,
+    0b0010001000
   }
-};  
+};
+
 
-static const uint8_t alphaChars8[36+1+1+4][8] = 
+// 8x8 font (for masking)
+static const uint8_t glyphIdx8[128] = 
 {
-  {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   // 0x00
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   // 0x10
+    0xff, 0xff, 0xff,   37,   38,   39,   40,   41, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   36, 0xff,   // 0x20
+       0,    1,    2,    3,    4,    5,    6,    7,    8,    9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   // 0x30
+    0xff,   10,   11,   12,   13,   14,   15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   // 0x40
+      25,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35, 0xff, 0xff, 0xff, 0xff, 0xff,   // 0x50
+    0xff,   10,   11,   12,   13,   14,   15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   // 0x60
+      25,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35, 0xff, 0xff, 0xff, 0xff, 0xff   // 0x70
+};
+
+static const uint8_t alphaCols8[42][8] = 
+{
+  {   // '0'
     0b01111110,
     0b11111111,
     0b11000011,
@@ -590,237 +624,237 @@ static const uint8_t alphaChars8[36+1+1+4][8] =
     0b11111111,
     0b01111110
   },
-  {
-    0b00011000,
-    0b01111000,
-    0b01111000,
-    0b00011000,
-    0b00011000,
-    0b00011000,
-    0b00011000,
-    0b00011000
-  },
-  {
-    0b11111110,
+  {   // '1'
+    0b00000000,
+    0b01100000,
+    0b01100000,
     0b11111111,
-    0b00000011,
-    0b00111111,
-    0b01111110,
-    0b11000000,
     0b11111111,
-    0b11111111
+    0b00000000,
+    0b00000000,
+    0b00000000
   },
-  {
-    0b11111110,
-    0b11111111,
-    0b00000011,
-    0b00111111,
-    0b00111111,
-    0b00000011,
-    0b11111111,
-    0b11111110,
+  {   // '2'
+    0b11000111,
+    0b11001111,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11111011,
+    0b01110011
   },
-  {
-    0b00000111,
-    0b00001111,
-    0b00011011,
-    0b00110011,
-    0b01100011,
+  {   // '3'
+    0b11000011,
+    0b11000011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
     0b11111111,
-    0b00000011,
-    0b00000011
+    0b01111110
   },
-  {
-    0b11111111,
-    0b11111111,
-    0b11000000,
-    0b11111110,
-    0b11111111,
-    0b00000011,
+  {   // '4'
+    0b00000100,
+    0b00001100,
+    0b00011100,
+    0b00110100,
+    0b01100100,
+    0b11000100,
     0b11111111,
-    0b11111110,
+    0b11111111
   },
-  {
-    0b01111111,
+  {   // '5'
+    0b11111011,
+    0b11111011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011111,
+    0b11001110
+  },
+  {   // '6'
+    0b01111110,
     0b11111111,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011111,
+    0b11001110
+  },
+  {   // '7'
     0b11000000,
-    0b11111110,
-    0b11111111,
-    0b11000011,
-    0b11111111,
-    0b01111110,
+    0b11000000,
+    0b11000000,
+    0b11000111,
+    0b11001111,
+    0b11011000,
+    0b11110000,
+    0b11100000
   },
-  {
+  {   // '8'
+    0b01110110,
     0b11111111,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
     0b11111111,
-    0b00000011,
-    0b00000110,
-    0b00001100,
-    0b00011000,
-    0b00011000,
-    0b00011000
+    0b01110110
   },
-  {
-    0b01111110,
-    0b11111111,
-    0b11000011,
-    0b11111111,
-    0b01111110,
-    0b11000011,
+  {   // '9'
+    0b01110010,
+    0b11111011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
     0b11111111,
     0b01111110
   },
-  {
-    0b01111110,
-    0b11111111,
-    0b11000011,
-    0b11111111,
-    0b01111111,
-    0b00000011,
-    0b11111111,
-    0b01111110   
-  },
-  {
-    0b01111110,
-    0b01111110,
-    0b11100111,
-    0b11000011,
-    0b11111111,
+  {   // 'A'
+    0b00111111,
     0b11111111,
-    0b11000011,
-    0b11000011
-  },
-  {
-    0b11111110,
+    0b11101100,
+    0b11001100,
+    0b11001100,
+    0b11101100,
     0b11111111,
-    0b11000011,
-    0b11111110,
-    0b11111110,
-    0b11000011,
+    0b00111111
+  },
+  {   // 'B'
     0b11111111,
-    0b11111110
+    0b11111111,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11111111,
+    0b01100110
   },
-  {
+  {   // 'C'
     0b01111110,
     0b11111111,
     0b11000011,
-    0b11000000,
-    0b11000000,
     0b11000011,
-    0b11111111,
-    0b01111110
+    0b11000011,
+    0b11000011,
+    0b11100111,
+    0b01100110
   },
-  {
-    0b11111110,
+  {   // 'D'
+    0b11111111,
     0b11111111,
     0b11000011,
     0b11000011,
     0b11000011,
     0b11000011,
     0b11111111,
-    0b11111110
+    0b01111110
   },
-  {
-    0b11111111,
-    0b11111111,
-    0b11000000,
-    0b11111100,
-    0b11111100,
-    0b11000000,
+  {   // 'E'
     0b11111111,
     0b11111111,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11000011,
+    0b11000011
   },
-  {
+  {   // 'F'
     0b11111111,
     0b11111111,
-    0b11000000,
-    0b11111100,
-    0b11111100,
-    0b11000000,
+    0b11011000,
+    0b11011000,
+    0b11011000,
+    0b11011000,
     0b11000000,
     0b11000000
   },
-  {
+  {   // 'G'
     0b01111110,
     0b11111111,
     0b11000011,
-    0b11000000,
-    0b11001111,
     0b11000011,
-    0b11111111,
-    0b01111110
+    0b11001011,
+    0b11001011,
+    0b11101111,
+    0b01101110
   },
-  {
-    0b11000011,
-    0b11000011,
-    0b11000011,
+  {   // 'H'
     0b11111111,
     0b11111111,
-    0b11000011,
-    0b11000011,
-    0b11000011
-  },
-  {
-    0b00111100,
-    0b00011000,
     0b00011000,
     0b00011000,
     0b00011000,
     0b00011000,
-    0b00011000,
-    0b00111100
+    0b11111111,
+    0b11111111
   },
-  {
-    0b00000011,
+  {   // 'I'
+    0b00000000,
+    0b00000000,
+    0b10000001,
+    0b11111111,
+    0b11111111,
+    0b10000001,
+    0b00000000,
+    0b00000000
+  },
+  {   // 'J'
+    0b00000110,
+    0b00000111,
     0b00000011,
     0b00000011,
     0b00000011,
     0b00000011,
-    0b11000011,
     0b11111111,
-    0b01111110
+    0b11111110
   },
-  {
+  {   // 'K'
+    0b11111111,
+    0b11111111,
+    0b00011000,
+    0b00011000,
+    0b00111100,
+    0b01100110,
     0b11000011,
-    0b11000110,
-    0b11001100,
-    0b11111000,
-    0b11111000,
-    0b11001100,
-    0b11000110,
-    0b11000011
+    0b10000001
   },
-  {
-    0b11000000,
-    0b11000000,
-    0b11000000,
-    0b11000000,
-    0b11000000,
-    0b11000000,
+  {   // 'L'
     0b11111111,
-    0b11111111
+    0b11111111,
+    0b00000011,
+    0b00000011,
+    0b00000011,
+    0b00000011,
+    0b00000011,
+    0b00000011
   },
-  {
-    0b11000011,
-    0b11100111,
+  {   // 'M'
     0b11111111,
-    0b11011011,
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b11000011
+    0b11111111,
+    0b01100000,
+    0b00110000,
+    0b00110000,
+    0b01100000,
+    0b11111111,
+    0b11111111
   },
-  {
-    0b11000011,
-    0b11100011,
-    0b11110011,
-    0b11011011,
-    0b11001111,
-    0b11000111,
-    0b11000011,
-    0b11000011
+  {   // 'N'
+    0b11111111,
+    0b11111111,
+    0b01100000,
+    0b00110000,
+    0b00011000,
+    0b00001100,
+    0b11111111,
+    0b11111111
   },
-  {
+  {   // 'O'
     0b01111110,
     0b11111111,
     0b11000011,
@@ -830,161 +864,167 @@ static const uint8_t alphaChars8[36+1+1+4][8] =
     0b11111111,
     0b01111110
   },
-  {
-    0b11111110,
+  {   // 'P'
     0b11111111,
-    0b11000011,
     0b11111111,
-    0b11111110,
-    0b11000000,
-    0b11000000,
-    0b11000000
+    0b11011000,
+    0b11011000,
+    0b11011000,
+    0b11011000,
+    0b11111000,
+    0b01110000
   },
-  {
+  {   // 'Q'
     0b01111110,
     0b11111111,
     0b11000011,
     0b11000011,
-    0b11000011,
-    0b11001101,
-    0b11110110,
-    0b01111011
+    0b11000101,
+    0b11000110,
+    0b11111011,
+    0b01111101
   },
-  {
-    0b11111110,
+  {   // 'R'
     0b11111111,
-    0b11000011,
-    0b11111110,
-    0b11111100,
-    0b11000110,
-    0b11000011,
-    0b11000011
+    0b11111111,
+    0b11011000,
+    0b11011000,
+    0b11011000,
+    0b11011100,
+    0b11110111,
+    0b01100011
   },
-  {
-    0b01111111,
+  {   // 'S'
+    0b01100011,
+    0b11111011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011011,
+    0b11011111,
+    0b11000110
+  },
+  {   // 'T'
+    0b11000000,
+    0b11000000,
+    0b11000000,
+    0b11111111,
     0b11111111,
     0b11000000,
-    0b01111110,
-    0b01111110,
+    0b11000000,
+    0b11000000
+  },
+  {   // 'U'
+    0b11111110,
+    0b11111111,
+    0b00000011,
+    0b00000011,
+    0b00000011,
     0b00000011,
     0b11111111,
     0b11111110
   },
-  {
+  {   // 'V'
+    0b11111000,
+    0b11111100,
+    0b00000110,
+    0b00000011,
+    0b00000011,
+    0b00000110,
+    0b11111100,
+    0b11111000
+  },
+  {   // 'W'
     0b11111111,
     0b11111111,
-    0b00011000,
-    0b00011000,
-    0b00011000,
-    0b00011000,
-    0b00011000,
-    0b00011000
-  },
-  {
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b11000011,
+    0b00000110,
+    0b00001100,
+    0b00001100,
+    0b00000110,
     0b11111111,
-    0b01111110
-  },
-  {
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b01100110,
-    0b00111100,
-    0b00011000
+    0b11111111
   },
-  {
-    0b11000011,
-    0b11000011,
-    0b11000011,
+  {   // 'X'
     0b11000011,
-    0b11011011,
-    0b11111111,
     0b11100111,
-    0b11000011
-    
-  },
-  {
-    0b11000011,
-    0b11000011,
-    0b01100110,
     0b00111100,
+    0b00011000,
+    0b00011000,
     0b00111100,
-    0b01100110,
-    0b11000011,
+    0b11100111,
     0b11000011
   },
-  {
-    0b11000011,
-    0b11000011,
-    0b11000011,
-    0b01100110,
-    0b00111100,
+  {   // 'Y'
+    0b11100000,
+    0b11110000,
     0b00011000,
+    0b00001111,
+    0b00001111,
     0b00011000,
-    0b00011000
+    0b11110000,
+    0b11100000
   },
-  {
-    0b11111111,
-    0b11111111,
-    0b00000110,
-    0b00001100,
-    0b00011000,
-    0b00110000,
-    0b11111111,
-    0b11111111
+  {   // 'Z'
+    0b11000011,
+    0b11000011,
+    0b11000111,
+    0b11001111,
+    0b11011011,
+    0b11110011,
+    0b11100011,
+    0b11000011
   },
-  {
-    0b00000000,
+  {   // '.'
     0b00000000,
     0b00000000,
     0b00000000,
+    0b00000011,
+    0b00000011,
     0b00000000,
     0b00000000,
-    0b00011000,
-    0b00011000
+    0b00000000
   },
-  {
-    0
+  {   // '#'
+    0b00000000,
+    0b00000000,
+    0b00000000,
+    0b00000000,
+    0b00000000,
+    0b00000000,
+    0b00000000,
+    0b00000000
   },
-  {
-    0b01111110,
-    0b11111111,
-    0b11111111,
+  {   // '$'
+    0b01111111,
     0b11111111,
     0b11111111,
+    0b11111110,
+    0b11111110,
     0b11111111,
     0b11111111,
-    0b11100111
+    0b01111111
   },
-  {
+  {   // '%'
     0b11111111,
-    0b10111101,
+    0b10111111,
     0b11111111,
+    0b11111101,
+    0b11111101,
     0b11111111,
-    0b11111111,
-    0b11111111,
-    0b11100111,
+    0b10111111,
     0b11111111
   },
-  {
-    0b11111111,
-    0b11111111,
-    0b11011011,
+  {   // '&'
     0b11111111,
     0b11111111,
-    0b11100111,
+    0b11011111,
+    0b11111011,
+    0b11111011,
+    0b11011111,
     0b11111111,
     0b11111111
   },
-  {
+  {   // '\''
     0b11111111,
     0b11111111,
     0b11111111,
@@ -992,8 +1032,9 @@ static const uint8_t alphaChars8[36+1+1+4][8] =
     0b11100111,
     0b11111111,
     0b11111111,
-    0b11111111,
-  },
-};  
+    0b11111111
+  }
+};
+
    
 #endif
@@ -0,0 +1,175 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Frame clock
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+
+#include "sid_frame.h"
+#include "sid_main.h"
+
+/*
+ * The frame clock paces all animations: Registered callbacks
+ * (idle patterns, time travel, SA, games) are called once per 
+ * tick, in order of registration, with the tick's timestamp and 
+ * the time since the previous tick. They draw into the display 
+ * buffer and call sid.requestShow(); the display is then flushed 
+ * exactly once per tick. Brightness fades are advanced right
+ * before that.
+ * 
+ * If a tick is late by more than one frame period (loop stalled 
+ * by WiFi, MQTT, SD etc), the missed ticks are not made up for,
+ * but counted as missed deadlines.
+ */
+
+static frameCallback frameCBs[FRAME_MAX_CB] = { NULL };
+static int           numFrameCBs = 0;
+
+static unsigned long framePeriod = 1000000 / FRAME_DEF_RATE;  // us
+static unsigned long nextTick = 0;      // us
+static unsigned long lastTick = 0;      // ms
+
+static uint32_t      frameCount = 0;
+static uint32_t      frameMissed = 0;
+
+#ifdef SID_DBG
+static unsigned long frameDbgNow = 0;
+static uint32_t      frameDbgCount = 0;
+#endif
+
+void frame_setup(uint16_t rate)
+{
+    frame_setRate(rate);
+
+    nextTick = micros();
+    lastTick = millis();
+    frameCount = frameMissed = 0;
+}
+
+void frame_setRate(uint16_t rate)
+{
+    if(rate < 10) rate = 10;
+    if(rate > 200) rate = 200;
+    
+    framePeriod = 1000000 / rate;
+}
+
+bool frame_register(frameCallback cb)
+{
+    for(int i = 0; i < numFrameCBs; i++) {
+        if(frameCBs[i] == cb)
+            return true;
+    }
+    
+    if(numFrameCBs >= FRAME_MAX_CB) {
+        #ifdef SID_DBG
+        Serial.println("frame_register: Too many callbacks");
+        #endif
+        return false;
+    }
+
+    frameCBs[numFrameCBs++] = cb;
+    
+    return true;
+}
+
+void frame_unregister(frameCallback cb)
+{
+    for(int i = 0; i < numFrameCBs; i++) {
+        if(frameCBs[i] == cb) {
+            numFrameCBs--;
+            for(int j = i; j < numFrameCBs; j++) {
+                frameCBs[j] = frameCBs[j + 1];
+            }
+            return;
+        }
+    }
+}
+
+// Returns true if a tick was executed
+bool frame_loop()
+{
+    unsigned long nowu = micros();
+    unsigned long late, now;
+
+    if((long)(nowu - nextTick) < 0)
+        return false;
+
+    late = nowu - nextTick;
+    if(late >= framePeriod) {
+        frameMissed += late / framePeriod;
+        nextTick = nowu + framePeriod;
+    } else {
+        nextTick += framePeriod;
+    }
+
+    now = millis();
+    
+    for(int i = 0; i < numFrameCBs; i++) {
+        frameCBs[i](now, now - lastTick);
+    }
+
+    sid.fadeLoop(now);
+    sid.flush();
+
+    lastTick = now;
+    frameCount++;
+
+    #ifdef SID_DBG
+    if(now - frameDbgNow >= 60*1000) {
+        Serial.printf("Frame clock: %lu fps, %u missed deadlines total\n", 
+            (frameCount - frameDbgCount) * 1000 / (now - frameDbgNow), frameMissed);
+        frameDbgNow = now;
+        frameDbgCount = frameCount;
+    }
+    #endif
+
+    return true;
+}
+
+// Time until next tick in us (0 if due)
+unsigned long frame_untilNext()
+{
+    long d = (long)(nextTick - micros());
+
+    return (d > 0) ? d : 0;
+}
+
+uint32_t frame_getCount()
+{
+    return frameCount;
+}
+
+uint32_t frame_getMissed()
+{
+    return frameMissed;
+}
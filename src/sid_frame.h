@@ -0,0 +1,55 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Frame clock
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SID_FRAME_H
+#define _SID_FRAME_H
+
+#define FRAME_DEF_RATE  60    // Default target frame rate (Hz)
+#define FRAME_MAX_CB     8    // Max number of registered callbacks
+
+// Frame callback: now = millis() at tick, delta = ms since previous tick
+typedef void (*frameCallback)(unsigned long now, unsigned long delta);
+
+void frame_setup(uint16_t rate = FRAME_DEF_RATE);
+void frame_setRate(uint16_t rate);
+
+bool frame_register(frameCallback cb);
+void frame_unregister(frameCallback cb);
+
+bool frame_loop();
+
+unsigned long frame_untilNext();
+
+uint32_t frame_getCount();
+uint32_t frame_getMissed();
+
+#endif
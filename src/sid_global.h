@@ -40,6 +40,37 @@
 // Uncomment for HomeAssistant MQTT protocol support
 #define SID_HAVEMQTT
 
+// Uncomment for temporal dithering: The display is refreshed several
+// times per frame, allowing single LEDs to be shown at intermediate 
+// intensities (eg peaks in the Spectrum Analyzer). Uses hardware timer 1.
+//#define SID_DITHER
+
+// Uncomment for virtual display (debugging): All i2c traffic to the
+// display is decoded by a model of the HT16K33s, and statistics (bus 
+// load, frame rate, show() timing) are printed on Serial every 10
+// seconds. If SID_VDISPLAY_DUMP is defined, changed frames are also
+// dumped as ASCII art, at most once per SID_VDISPLAY_DUMP ms. The
+// host tests in test/disp build the display with this model.
+//#define SID_VDISPLAY
+//#define SID_VDISPLAY_DUMP 500
+
+// Uncomment to seed the random number generator for animations (idle
+// patterns, TT sequence, games) with a fixed value, making all random
+// sequences reproducible.
+//#define SID_RAND_SEED 0x12345678
+
+// IR key auto-repeat: A held key repeats after SID_IR_REPEAT_DELAY ms,
+// every SID_IR_REPEAT_RATE ms (Siddly moves, brightness). Only works
+// with remotes sending repeat frames (NEC, Sony SIRC, RC5, RC6).
+#define SID_IR_REPEAT_DELAY 250
+#define SID_IR_REPEAT_RATE   80
+
+// Uncomment to print every received IR transmission (durations of
+// marks/spaces, hash, decoded code) on Serial, along with how well 
+// the hash of this code survives timing jitter. For collecting traces
+// of remotes; the host tests in test/ir replay them.
+//#define SID_IR_DUMP
+
 // --- end of config options
 
 /*************************************************************************
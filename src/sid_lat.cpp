@@ -0,0 +1,214 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Time travel latency statistics
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+
+#include "sid_main.h"
+#include "sid_lat.h"
+
+/*
+ * Trigger-to-photon latency of time travels
+ *
+ * Each time travel is timestamped (in us) at four stages:
+ * 0 - Trigger: TT pin edge (timestamped by SIDButton's ISR), BTTFN 
+ *     packet or MQTT message
+ * 1 - Trigger consumed in main_loop()
+ * 2 - timeTravel() entered
+ * 3 - First show() of the display after that
+ * The last LAT_SAMPLES measurements are kept per trigger source;
+ * lat_report() condenses them into min/avg/max per stage and
+ * a log2 histogram of the total latency.
+ */
+
+#define LAT_EDGE_MAX_AGE 6000000UL  // Older edges/packets not taken as trigger
+#define LAT_SHOW_TIMEOUT 10000000UL // Drop measurement if no show() within (us)
+
+#define LAT_IDLE     0
+#define LAT_CONSUMED 1
+#define LAT_TT       2
+
+typedef struct {
+    uint32_t stage[3];   // Stage 0->1, 1->2, 2->3 in us
+} latSample;
+
+static latSample latSamples[LAT_NUM_SRC][LAT_SAMPLES];
+static uint8_t   latIdx[LAT_NUM_SRC]   = { 0 };
+static uint16_t  latCount[LAT_NUM_SRC] = { 0 };
+
+static const char *latSrcNames[LAT_NUM_SRC] = {
+    "Button", "GPIO", "BTTFN", "MQTT"
+};
+
+static uint8_t       netSrc = LAT_SRC_BTTFN;
+static unsigned long netUs = 0;
+
+static int           latState = LAT_IDLE;
+static uint8_t       latSrc = 0;
+static unsigned long latUs[3];
+
+static void lat_commit(unsigned long showUs);
+
+// BTTFN/MQTT trigger received
+void lat_received(uint8_t src)
+{
+    netSrc = src;
+    netUs = micros();
+}
+
+// main_loop() picked up the trigger. For the TT button/GPIO, 
+// triggerUs is the time of the triggering edge.
+void lat_consumed(uint8_t src, unsigned long triggerUs)
+{
+    unsigned long now = micros();
+    unsigned long t0 = triggerUs;
+
+    if(src == LAT_SRC_NETWORK) {
+        src = netSrc;
+        t0 = netUs;
+    }
+
+    if(now - t0 > LAT_EDGE_MAX_AGE) t0 = now;
+
+    latSrc = src;
+    latUs[0] = t0;
+    latUs[1] = now;
+    latState = LAT_CONSUMED;
+}
+
+// timeTravel() entered
+void lat_ttStart()
+{
+    if(latState != LAT_CONSUMED)
+        return;
+        
+    latUs[2] = micros();
+    latState = LAT_TT;
+    sid.markNextShow();
+}
+
+// Called after frame_loop(): Check for first show()
+void lat_loop()
+{
+    unsigned long showUs;
+    
+    if(latState != LAT_TT)
+        return;
+
+    if(sid.getMarkedShow(showUs)) {
+        lat_commit(showUs);
+        latState = LAT_IDLE;
+    } else if(micros() - latUs[2] > LAT_SHOW_TIMEOUT) {
+        latState = LAT_IDLE;
+    }
+}
+
+static void lat_commit(unsigned long showUs)
+{
+    latSample *s = &latSamples[latSrc][latIdx[latSrc]];
+
+    s->stage[0] = latUs[1] - latUs[0];
+    s->stage[1] = latUs[2] - latUs[1];
+    s->stage[2] = showUs - latUs[2];
+
+    latIdx[latSrc] = (latIdx[latSrc] + 1) % LAT_SAMPLES;
+    if(latCount[latSrc] < 0xffff) latCount[latSrc]++;
+
+    #ifdef SID_DBG
+    Serial.printf("TT latency (%s): %u/%u/%uus\n", 
+        latSrcNames[latSrc], s->stage[0], s->stage[1], s->stage[2]);
+    {
+        char buf[512];
+        lat_report(buf, sizeof(buf));
+        Serial.print(buf);
+    }
+    #endif
+}
+
+/*
+ * Print statistics to buf, one line per source with samples:
+ * <src> n=<total count> <stage>=min/avg/max(us)... hist=<buckets>
+ * Returns length of string.
+ */
+int lat_report(char *buf, int bufSize)
+{
+    int len = 0;
+
+    buf[0] = 0;
+    
+    for(int i = 0; i < LAT_NUM_SRC && len < bufSize - 1; i++) {
+      
+        int num = (latCount[i] < LAT_SAMPLES) ? latCount[i] : LAT_SAMPLES;
+        uint32_t mn[4], mx[4], sum[4];
+        uint8_t  hist[LAT_BUCKETS] = { 0 };
+
+        if(!num) continue;
+
+        for(int k = 0; k < 4; k++) {
+            mn[k] = 0xffffffff; mx[k] = sum[k] = 0;
+        }
+
+        for(int j = 0; j < num; j++) {
+            uint32_t v[4];
+            int b = 0;
+            v[0] = latSamples[i][j].stage[0];
+            v[1] = latSamples[i][j].stage[1];
+            v[2] = latSamples[i][j].stage[2];
+            v[3] = v[0] + v[1] + v[2];
+            for(int k = 0; k < 4; k++) {
+                if(v[k] < mn[k]) mn[k] = v[k];
+                if(v[k] > mx[k]) mx[k] = v[k];
+                sum[k] += v[k];
+            }
+            for(uint32_t ms = v[3] / 1000; ms && b < LAT_BUCKETS - 1; ms >>= 1) b++;
+            hist[b]++;
+        }
+
+        len += snprintf(buf + len, bufSize - len, "%s n=%d", latSrcNames[i], latCount[i]);
+        for(int k = 0; k < 4 && len < bufSize - 1; k++) {
+            len += snprintf(buf + len, bufSize - len, " %s=%u/%u/%u", 
+                (k == 3) ? "total" : ((k == 0) ? "recv" : ((k == 1) ? "tt" : "show")),
+                mn[k], sum[k] / num, mx[k]);
+        }
+        for(int k = 0; k < LAT_BUCKETS && len < bufSize - 1; k++) {
+            len += snprintf(buf + len, bufSize - len, k ? ",%d" : " hist=%d", hist[k]);
+        }
+        if(len < bufSize - 1) {
+            len += snprintf(buf + len, bufSize - len, "\n");
+        }
+    }
+
+    if(len >= bufSize) len = bufSize - 1;
+    
+    return len;
+}
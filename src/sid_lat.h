@@ -0,0 +1,55 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Time travel latency statistics
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SID_LAT_H
+#define _SID_LAT_H
+
+// Trigger sources
+#define LAT_SRC_BUTTON   0    // TT button
+#define LAT_SRC_GPIO     1    // TCD connected by wire
+#define LAT_SRC_BTTFN    2    // BTTFN notification
+#define LAT_SRC_MQTT     3    // MQTT (TCD or user command)
+#define LAT_NUM_SRC      4
+#define LAT_SRC_NETWORK  0xff // For lat_consumed(): Source given to lat_received()
+
+#define LAT_SAMPLES     16    // Samples kept per source
+#define LAT_BUCKETS     11    // Histogram: <1ms, <2ms, <4ms ... <512ms, >=512ms
+
+void lat_received(uint8_t src);
+void lat_consumed(uint8_t src, unsigned long triggerUs = 0);
+void lat_ttStart();
+
+void lat_loop();
+
+int  lat_report(char *buf, int bufSize);
+
+#endif
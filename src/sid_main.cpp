@@ -42,6 +42,14 @@
 #include "sid_sa.h"
 #include "sid_siddly.h"
 #include "sid_snake.h"
+#include "sid_frame.h"
+#include "sid_text.h"
+#include "sid_sched.h"
+#include "sid_rand.h"
+#include "sid_anim.h"
+#include "sid_tween.h"
+#include "sid_rec.h"
+#include "sid_lat.h"
 
 unsigned long powerupMillis = 0;
 
@@ -49,7 +57,7 @@ unsigned long powerupMillis = 0;
 sidDisplay sid(0x74, 0x72);
 
 // The IR-remote object
-static IRRemote ir_remote(0, IRREMOTE_PIN);
+static IRRemote ir_remote(IRREMOTE_PIN);
 static uint8_t IRFeedBackPin = IR_FB_PIN;
 
 // The tt button / TCD tt trigger
@@ -77,6 +85,7 @@ uint16_t networkLead   = ETTO_LEAD;
 #define SID_IDLE_3    3
 #define SID_IDLE_BL   4   // "backlot mode"
 #define SID_IDLE_IDC  5   // text / "identity crisis"
+#define SID_IDLE_ANIM 6   // 6-9: animations from SD/flash ("/idle6.sda" etc)
 
 #define SBLF_REPEAT   1
 #define SBLF_ISTT     2
@@ -86,6 +95,9 @@ uint16_t networkLead   = ETTO_LEAD;
 #define SBLF_NOBL     32
 #define SBLF_ANIM     64
 #define SBLF_STRICT   128
+#define SBLF_TWEEN    256
+
+#define IDLE_TWEEN_EASE  SD_EASE_INOUT   // Easing between idle keyframes (modes 0-3)
 uint16_t              idleMode = 0;
 bool                  strictMode = true;
 static int            sidBaseLine = 0;
@@ -142,9 +154,7 @@ bool                 TTrunning = false;  // TT sequence is running
 static bool          extTT = false;      // TT was triggered by TCD
 static unsigned long TTstart = 0;
 static unsigned long P0duration = ETTO_LEAD;
-static bool          TTP0 = false;
-static bool          TTP1 = false;
-static bool          TTP2 = false;
+static int           TTphase = 0;
 static unsigned long TTFInt = 0;
 static unsigned long TTFDelay = 0;
 static unsigned long TTfUpdNow = 0;
@@ -263,6 +273,8 @@ static const int TTampFacts[TT_AMP_STEPS] = {
 #define P1_DUR          5000    // time tunnel phase
 #define P2_DUR          3000    // re-entry phase
 
+#define TT_NUM_PHASES   3
+
 bool         TCDconnected = false;
 static bool  noETTOLead = false;
 
@@ -273,11 +285,19 @@ static unsigned long ipachgnow = 0;
 static bool          irlchanged = false;
 static unsigned long irlchgnow = 0;
 
+#define SS_FADE_OUT  1000   // Screen saver fade durations (ms)
+#define SS_FADE_IN    300
+
 static unsigned long ssLastActivity = 0;
 static unsigned long ssDelay = 0;
 static unsigned long ssOrigDelay = 0;
 static bool          ssActive = false;
 
+static bool          startupRunning = false;
+static uint8_t       startupBri;
+static uint8_t       startupW[10];
+static void          (*startupDone)() = NULL;
+
 static bool          nmOld = false;
 static bool          fpoOld = false;
 bool                 FPBUnitIsOn = true;
@@ -316,6 +336,27 @@ static bool          inputRecord = false;
 static unsigned long lastKeyPressed = 0;
 static int           maxIRctrls = NUM_REM_TYPES;
 
+// Code -> key map for remote_codes (open addressing, linear probing).
+// Must be at least twice the number of codes.
+#define IR_MAP_SIZE   128
+#define IR_MAP_SHIFT  (32 - 7)
+static uint32_t      irMapCodes[IR_MAP_SIZE];
+static int8_t        irMapKeys[IR_MAP_SIZE];
+
+static_assert(IR_MAP_SIZE >= 2 * NUM_IR_KEYS * NUM_REM_TYPES, "IR_MAP_SIZE too small");
+
+// Held key (auto-repeat)
+// Release timeout counts from the end of the last frame: Longest repeat
+// period (RC5: 114ms, end to end), plus gap detection (5ms) and main 
+// loop latency.
+#define IR_RELEASE_TO   150000  // us after end of frame until key counts as released
+static int           irHeldKey = -1;
+static uint32_t      irHeldHash = 0;
+static bool          irKeyDown = false;
+static unsigned long irHeldLast = 0;
+static unsigned long irNextRepeat = 0;
+static_assert(IR_MAP_SIZE == (1 << (32 - IR_MAP_SHIFT)), "IR_MAP_SHIFT does not match IR_MAP_SIZE");
+
 #define IR_FEEDBACK_DUR 300
 static bool          irFeedBack = false;
 static unsigned long irFeedBackNow = 0;
@@ -375,24 +416,33 @@ static uint32_t commandQueue[16] = { 0 };
 
 static void startIRLearn();
 static void endIRLearn(bool restore);
+static void buildIRMap();
 static void handleIRinput();
 static void handleIRKey(int command);
+static void handleIRKeyRepeat(int key);
+static void irKeyLoop();
 static void handleRemoteCommand();
 static bool execute(bool isIR);
 static void startIRfeedback();
 static void endIRfeedback();
+static long irFeedbackEndTask(int step);
 
+static void main_frame(unsigned long now, unsigned long delta);
 static void showBaseLine(int variation = 20, uint16_t flags = 0);
 static void showIdle(bool freezeBaseLine = false);
-static void play_startup();
+static bool idleInit(int mode);
+static void play_startup(void (*done)() = NULL);
+static void stop_startup();
+static void powerOnDone();
 static void timeTravel(bool TCDtriggered, uint16_t P0Dur);
 
 static void showChar(const char text);
-static void fadeOutChar();
 
 static void span_start();
 static void span_stop(bool skipClearDisplay = false);
-static void siddly_start();
+static bool toggleRecording(int num);
+static void stopRecording();
+static void siddly_start(bool demo = false);
 static void siddly_stop();
 static void snake_start();
 static void snake_stop();
@@ -417,15 +467,25 @@ void main_boot()
 {
     // Boot display, keep it dark
     sid.begin();
+
+    #ifdef SID_DITHER
+    sid.startDither(1);
+    #endif
 }
 
 void main_setup()
 {
     Serial.println(F("Status Indicator Display version " SID_VERSION " " SID_VERSION_EXTRA));
 
+    // Seed PRNG for animations (RF is up now)
+    rand_setup();
+
     // Load settings
     loadBrightness();
     loadIdlePat();                    // load idleMode and strictMode
+    if(!idleInit(idleMode)) {
+        idleMode = SID_IDLE_0;
+    }
     updateConfigPortalStrictValue();  // Update current CP value
     loadIRLock();
 
@@ -441,6 +501,8 @@ void main_setup()
 
     if((atoi(settings.disDIR) > 0)) 
         maxIRctrls--;
+
+    buildIRMap();
     
     // [formerly started CP here]
 
@@ -476,12 +538,27 @@ void main_setup()
     #endif
     ir_remote.begin();
 
+    // Loop sleeps between deadlines; IR and TT button wake it up
+    sched_setup();
+    ir_remote.setWakeup(sched_wakeupFromISR);
+    TTKey.begin();
+    TTKey.setWakeup(sched_wakeupFromISR);
+
     // Initialize BTTF network
     bttfn_setup();
     bttfn_loop();
 
+    // Set up frame clock; order of registration 
+    // is order of execution
+    frame_setup();
+    frame_register(main_frame);
+    frame_register(sa_frame);
+    frame_register(si_frame);
+    frame_register(sn_frame);
+    frame_register(text_frame);   // last: draws over everything else
+
     // Other inits
-    idleDelay2 = 800 + ((int)(esp_random() % 200) - 100);
+    idleDelay2 = 800 + ((int)rand_below(200) - 100);
 
     // If "Follow TCD fake power" is set,
     // stay silent and dark
@@ -495,8 +572,7 @@ void main_setup()
 
         // Light up IR feedback for 500ms
         startIRfeedback();
-        mydelay(500, false);
-        endIRfeedback();
+        sched_add(irFeedbackEndTask, 500);
 
         Serial.println("Waiting for TCD fake power on");
     
@@ -505,10 +581,8 @@ void main_setup()
         // Otherwise boot:
         FPBUnitIsOn = true;
 
-        // Play startup sequence
-        play_startup();
-        
-        ssRestartTimer();
+        // Play startup sequence, then start screen saver timer
+        play_startup(ssRestartTimer);
         
     }
 
@@ -548,6 +622,8 @@ void main_loop()
             }
             
             // Display OFF
+            stop_startup();
+            text_abort();
             sid.off();
 
             // Backup last mode (idle or sa)
@@ -573,23 +649,16 @@ void main_loop()
             isTTKeyHeld = isTTKeyPressed = false;
             networkTimeTravel = false;
 
-            // Play startup sequence
-            play_startup();
-
-            ssRestartTimer();
             ssActive = false;
 
             sidBaseLine = strictBaseLine = 0;
             LMState = LMIdx = id5idx = 0;
 
-            ir_remote.loop();
-
             // FIXME - anything else?
 
-            // Restore sa mode if active before FPO
-            if(FPOSAMode > 0) {
-                span_start();
-            }
+            // Play startup sequence, then restore sa mode 
+            // if active before FPO
+            play_startup(powerOnDone);
  
         }
         fpoOld = tcdFPO;
@@ -626,23 +695,25 @@ void main_loop()
     // IR Remote loop
     if(FPBUnitIsOn) {
         if(ir_remote.loop()) {
-            handleIRinput();
+            // Ignore IR while text/startup sequence is displayed
+            if(!text_busy() && !startupRunning) handleIRinput();
         }
+        irKeyLoop();
         handleRemoteCommand();
     }
 
-    // Spectrum analyzer / Siddly / Snake loops
+    // Spectrum analyzer audio processing (display is done in frame callback)
     if(FPBUnitIsOn && !TTrunning) {
         //unsigned long now2 = millis();
         sa_loop();    // 17ms: float / 28ms: double FFT [400Khz i2c, Rectangle]
         //now2 = millis() - now2;
         //Serial.printf("%d\n", now2);
-        si_loop();
-        sn_loop();
+        // Loop is paced by i2s while audio is processed
+        if(saActive) sched_stayAwake();
     }
 
     // TT button evaluation
-    if(FPBUnitIsOn && !TTrunning) {
+    if(FPBUnitIsOn && !TTrunning && !startupRunning) {
         ttkeyScan();
         if(isTTKeyHeld) {
             ssEnd();
@@ -670,6 +741,7 @@ void main_loop()
                 if(TCDconnected) {
                     ssEnd();
                 }
+                lat_consumed(TCDconnected ? LAT_SRC_GPIO : LAT_SRC_BUTTON, TTKey.getEventTime());
                 timeTravel(TCDconnected, noETTOLead ? 0 : ETTO_LEAD);
             }
         }
@@ -678,302 +750,313 @@ void main_loop()
         if(networkTimeTravel) {
             networkTimeTravel = false;
             ssEnd();
+            lat_consumed(LAT_SRC_NETWORK);
             timeTravel(networkTCDTT, networkLead);
         }
+    } else {
+        // TT button not evaluated; discard its edges
+        TTKey.flush();
     }
 
-    now = millis();
-    
-    if(TTrunning) {
+    // Scheduled tasks (startup sequence etc)
+    sched_loop();
 
-        if(extTT) {
-
-            // ***********************************************************************************
-            // TT triggered by TCD (BTTFN, GPIO or MQTT) *****************************************
-            // ***********************************************************************************
-
-            if(TTP0) {   // Acceleration - runs for ETTO_LEAD ms by default
-
-                if(!networkAbort && (now - TTstart < P0duration)) {
-
-                    if(!TTFDelay || (now - TTfUpdNow >= TTFDelay)) {
-
-                        if(TTFDelay) {
-                            TTFDelay = 0;
-                            TTfUpdNow = now;
-                        } else if(TTFInt && (now - TTfUpdNow >= TTFInt)) {                          
-                            if(saActive) {
-                                if(TTcnt > 0) {
-                                    TTcnt--;
-                                    sa_setAmpFact(TTampFacts[TT_AMP_STEPS - 1 - TTcnt]);
-                                }
-                            } else {
-                                if(TTcnt > 0) {
-                                    TTcnt--;
-                                    if(TTsbFlags & SBLF_STRICT) {
-                                        for(int i = 0; i < 10; i++) {
-                                            sid.drawBarWithHeight(i, ttledseqfull[TT_SQF_LN - 1 - TTcnt][i]);
-                                        }
-                                    } else {
-                                        for(int i = 0; i < 10; i++) {
-                                            sid.drawBarWithHeight(i, ttledseq[TT_SQ_LN - 1 - TTcnt][i]);
-                                        }
-                                    }
-                                    sid.show();
-                                }
-                            }
-                            TTfUpdNow = now;
-                        }
-
-                        if(saActive) {
-                            sa_loop();
-                        }
+    // Animations: Run frame callbacks (time travel/idle,
+    // SA, games) and flush display once per frame
+    frame_loop();
 
-                    } else {
+    // Latency statistics: Timestamp first show() after TT
+    lat_loop();
 
-                        if(saActive) {
-                            sa_loop();                            
-                        } else {
-                            showIdle(true);
-                        }
+    // Follow TCD night mode
+    if(useNM && (tcdNM != nmOld)) {
+        if(tcdNM) {
+            // NM on: Set Screen Saver timeout to 10 seconds
+            ssDelay = 10 * 1000;
+            sidNM = true;
+        } else {
+            // NM off: End Screen Saver; reset timeout to old value
+            ssEnd();  // Doesn't do anything if fake power is off
+            ssDelay = ssOrigDelay;
+            sidNM = false;
+        }
+        nmOld = tcdNM;
+    }
 
-                    }
+    now = millis();
 
-                } else {
+    // If network is interrupted, return to stand-alone
+    if(useBTTFN) {
+        if( (lastBTTFNpacket && (now - lastBTTFNpacket > 30*1000)) ||
+            (!BTTFNBootTO && !lastBTTFNpacket && (now - powerupMillis > 60*1000)) ) {
+            tcdNM = false;
+            tcdFPO = false;
+            gpsSpeed = -1;
+            lastBTTFNpacket = 0;
+            BTTFNBootTO = true;
+        }
+    }
 
-                    if(TTstart == TTfUpdNow) {
-                        // If we have skipped P0, set last step of sequence at least
-                        // Do this also in sa mode and if strict (pattern is same)
-                        for(int i = 0; i < 10; i++) {
-                            sid.drawBarWithHeight(i, ttledseq[TT_SQ_LN - 1][i]);
-                        }
-                        sid.show();
-                    }
+    if(!TTrunning) {
+        // Save brightness 10 seconds after last change
+        if(brichanged && (now - brichgnow > 10000)) {
+            brichanged = false;
+            saveBrightness();
+        }
+    
+        // Save idle pattern 10 seconds after last change
+        if(ipachanged && (now - ipachgnow > 10000)) {
+            ipachanged = false;
+            saveIdlePat();
+        }
+    
+        // Save irlock 10 seconds after last change
+        if(irlchanged && (now - irlchgnow > 10000)) {
+            irlchanged = false;
+            saveIRLock();
+        }
+    }
+}
 
-                    if(saActive) {
-                        //span_stop(true);
-                        sa_deactivate();
-                        TTSAStopped = true;
-                    }
+/*
+ * Time travel sequence
+ * 
+ * The sequence consists of phases, each described by an entry in
+ * ttPhases[]: Where the phase's duration comes from, the frame
+ * interval set when it starts, and functions called upon entry, on
+ * every frame clock tick while the phase lasts, and when it ends.
+ * The sequence is identical for all trigger sources, only the 
+ * duration sources differ: A TCD-triggered TT (GPIO, BTTFN, MQTT)
+ * lasts as long as the TCD says (ETTO lead, re-entry signal), a 
+ * stand-alone TT (button, IR, MQTT) uses P0_DUR and P1_DUR.
+ * All functions take the current time as a parameter and do not
+ * read the clock themselves.
+ */
 
-                    TTP0 = false;
-                    TTP1 = true;
-                    sidBaseLine = 19;
-                    strictBaseLine = TT_SQF_LN - 1;
-                    TTstart = TTfUpdNow = now;
-                    TTFInt = 1000 + ((int)(esp_random() % 200) - 100);
+#define TTDUR_LEAD    0   // P0duration: TCD's ETTO lead or P0_DUR
+#define TTDUR_TUNNEL  1   // Until TCD signals re-entry, or P1_DUR
+#define TTDUR_SAAMP   2   // Until SA amplification is back to normal
+
+typedef struct {
+    uint8_t  durSrc;                      // TTDUR_xxx
+    uint16_t fInt;                        // Frame interval set on entry (0 = keep)
+    uint16_t fJitter;                     // Random variation of fInt
+    void     (*enter)(unsigned long now);
+    void     (*render)(unsigned long now);
+    void     (*leave)(unsigned long now);
+} ttPhase;
+
+static void ttAccelRender(unsigned long now);
+static void ttAccelLeave(unsigned long now);
+static void ttTunnelEnter(unsigned long now);
+static void ttTunnelRender(unsigned long now);
+static void ttTunnelLeave(unsigned long now);
+static void ttReentryEnter(unsigned long now);
+static void ttReentryRender(unsigned long now);
+
+static const ttPhase ttPhases[TT_NUM_PHASES] = {
+    { TTDUR_LEAD,      0,   0, NULL,           ttAccelRender,   ttAccelLeave  },  // P0: Acceleration
+    { TTDUR_TUNNEL, 1000, 200, ttTunnelEnter,  ttTunnelRender,  ttTunnelLeave },  // P1: Peak/"time tunnel"
+    { TTDUR_SAAMP,    50,   0, ttReentryEnter, ttReentryRender, NULL          }   // P2: Reentry
+};
 
-                    TTClrBar = TTBarCnt = 0;
-                    TTClrBarInc = 1;
-                    TTBri = false;
+static bool ttPhaseOver(uint8_t durSrc, unsigned long now)
+{
+    switch(durSrc) {
+    case TTDUR_LEAD:
+        return (extTT && networkAbort) || (now - TTstart >= P0duration);
+    case TTDUR_TUNNEL:
+        if(!extTT) {
+            return (now - TTstart >= P1_DUR);
+        }
+        if(networkTCDTT) {
+            return (networkReentry || networkAbort);
+        }
+        return !digitalRead(TT_IN_PIN);
+    case TTDUR_SAAMP:
+        // Idle mode: Let showIdle take care of calming us down
+        // SA mode: reduce ampFactor gradually
+        return !(saActive && sa_setAmpFact(-1) > 100);
+    }
+    
+    return true;
+}
 
-                    TTLMIdx = 0;
-                    TTLMTrigger = false;
+static void ttEnd()
+{
+    TTrunning = false;
+    isTTKeyHeld = isTTKeyPressed = false;
+    ssRestartTimer();
+    sa_setAmpFact(100);
+    LMState = LMIdx = id5idx = 0;
+}
 
-                }
+static void tt_frame(unsigned long now)
+{
+    const ttPhase *p = &ttPhases[TTphase];
+
+    while(ttPhaseOver(p->durSrc, now)) {
+        
+        if(p->leave) p->leave(now);
+        
+        if(++TTphase >= TT_NUM_PHASES) {
+            ttEnd();
+            return;
+        }
+        
+        p = &ttPhases[TTphase];
+        
+        TTstart = TTfUpdNow = now;
+        if(p->fInt) {
+            TTFInt = p->fInt;
+            if(p->fJitter) {
+                TTFInt += (int)rand_below(p->fJitter) - (p->fJitter / 2);
             }
-            if(TTP1) {   // Peak/"time tunnel" - ends with pin going LOW or MQTT "REENTRY"
-
-                if( (networkTCDTT && (!networkReentry && !networkAbort)) || (!networkTCDTT && digitalRead(TT_IN_PIN))) 
-                {
-
-                    if(TTFInt && (now - TTfUpdNow >= TTFInt)) {
-                        if(TTLMTrigger) {
-                            TTLMIdx++;
-                            if(!LMTT[TTLMIdx]) TTLMIdx = 0;
-                        }
-                        showBaseLine(80, TTsbFlags | SBLF_ISTT);
-                        TTfUpdNow = now;
-                        if(TTsbFlags & SBLF_LMTT) {
-                            TTLMTrigger = true;
-                            TTFInt = 130;
-                        } else {
-                            TTFInt = 100 + ((int)(esp_random() % 100) - 50);
-                        }
-                    }
-                    
-                } else {
+        }
+        
+        if(p->enter) p->enter(now);
+    }
+
+    p->render(now);
+}
 
-                    TTP1 = false;
-                    TTP2 = true;
+// P0: Acceleration
 
-                    sid.setBrightness(255);
+static void ttAccelRender(unsigned long now)
+{
+    if(TTFDelay && (now - TTfUpdNow < TTFDelay)) {
+        if(saActive) {
+            sa_loop();
+        } else {
+            showIdle(true);
+        }
+        return;
+    }
 
-                    TTFInt = 50;
-                    TTfUpdNow = now;
-                    
+    if(TTFDelay) {
+        TTFDelay = 0;
+        TTfUpdNow = now;
+    } else if(TTFInt && (now - TTfUpdNow >= TTFInt)) {
+        if(TTcnt > 0) {
+            TTcnt--;
+            if(saActive) {
+                sa_setAmpFact(TTampFacts[TT_AMP_STEPS - 1 - TTcnt]);
+            } else if(TTsbFlags & SBLF_STRICT) {
+                for(int i = 0; i < 10; i++) {
+                    sid.drawBarWithHeight(i, ttledseqfull[TT_SQF_LN - 1 - TTcnt][i]);
+                }
+                sid.requestShow();
+            } else {
+                for(int i = 0; i < 10; i++) {
+                    sid.drawBarWithHeight(i, ttledseq[TT_SQ_LN - 1 - TTcnt][i]);
                 }
+                sid.requestShow();
             }
-            if(TTP2) {   // Reentry - up to us
+        }
+        TTfUpdNow = now;
+    }
 
-                // Idle mode: Let showIdle take care of calming us down
-                // SA mode: reduce ampFactor gradually
+    if(saActive) {
+        sa_loop();
+    }
+}
 
-                if(TTSAStopped) {
-                    sa_activate(false, 500);
-                    TTSAStopped = false;
-                }
-                if(saActive && sa_setAmpFact(-1) > 100) {
-                    if(now - TTfUpdNow >= TTFInt) {
-                        TTcnt++;
-                        if(TTcnt <= TT_AMP_STEPS) {
-                            sa_setAmpFact(TTampFacts[TT_AMP_STEPS - 1 - TTcnt]);
-                        }
-                        TTfUpdNow = now;
-                        TTFInt = 400 + ((int)(esp_random() % 100) - 50);
-                    }
-                    sa_loop();
-                } else {
-                    TTP2 = false;
-                    TTrunning = false;
-                    isTTKeyHeld = isTTKeyPressed = false;
-                    ssRestartTimer();
-                    sa_setAmpFact(100);
-                    LMState = LMIdx = id5idx = 0;
-                }
+static void ttAccelLeave(unsigned long now)
+{
+    tween_stop();
 
-            }
-          
-        } else {
+    if(TTstart == TTfUpdNow) {
+        // If we have skipped P0, set last step of sequence at least
+        // Do this also in sa mode and if strict (pattern is same)
+        for(int i = 0; i < 10; i++) {
+            sid.drawBarWithHeight(i, ttledseq[TT_SQ_LN - 1][i]);
+        }
+        sid.requestShow();
+    }
 
-            // ****************************************************************************
-            // TT triggered by button (if TCD not connected), MQTT or IR ******************
-            // ****************************************************************************
-          
-            if(TTP0) {   // Acceleration - runs for P0_DUR ms
-
-                if(now - TTstart < P0_DUR) {
-
-                    // TT acceleration (use gpsSpeed if available)
-
-                    if(!TTFDelay || (now - TTfUpdNow >= TTFDelay)) {
-
-                        TTFDelay = 0;
-                        if(TTFInt && (now - TTfUpdNow >= TTFInt)) {
-                            if(saActive) {
-                                if(TTcnt > 0) {
-                                    TTcnt--;
-                                    sa_setAmpFact(TTampFacts[TT_AMP_STEPS - 1 - TTcnt]);
-                                }
-                            } else {
-                                if(TTcnt > 0) {
-                                    TTcnt--;
-                                    if(TTsbFlags & SBLF_STRICT) {
-                                        for(int i = 0; i < 10; i++) {
-                                            sid.drawBarWithHeight(i, ttledseqfull[TT_SQF_LN - 1 - TTcnt][i]);
-                                        }
-                                    } else {
-                                        for(int i = 0; i < 10; i++) {
-                                            sid.drawBarWithHeight(i, ttledseq[TT_SQ_LN - 1 - TTcnt][i]);
-                                        }
-                                    }
-                                    sid.show();
-                                }
-                            }
-                            TTfUpdNow = now;
-                        }
-                        
-                        if(saActive) {
-                            sa_loop();
-                        }
+    if(saActive) {
+        sa_deactivate();
+        TTSAStopped = true;
+    }
+}
 
-                    } else {
-                        
-                        if(saActive) {
-                            sa_loop();
-                        } else {
-                            showIdle(true);
-                        }
+// P1: Peak/"time tunnel"
 
-                    }
+static void ttTunnelEnter(unsigned long now)
+{
+    sidBaseLine = 19;
+    strictBaseLine = TT_SQF_LN - 1;
 
-                } else {
+    TTClrBar = TTBarCnt = 0;
+    TTClrBarInc = 1;
+    TTBri = false;
 
-                    if(saActive) {
-                        sa_deactivate();
-                        TTSAStopped = true;
-                    }
+    TTLMIdx = 0;
+    TTLMTrigger = false;
+}
 
-                    TTP0 = false;
-                    TTP1 = true;
-                    sidBaseLine = 19;
-                    strictBaseLine = TT_SQF_LN - 1;
-                    TTstart = TTfUpdNow = now;
-                    TTFInt = 1000 + ((int)(esp_random() % 200) - 100);
+static void ttTunnelRender(unsigned long now)
+{
+    if(TTFInt && (now - TTfUpdNow >= TTFInt)) {
+        if(TTLMTrigger) {
+            TTLMIdx++;
+            if(!LMTT[TTLMIdx]) TTLMIdx = 0;
+        }
+        showBaseLine(80, TTsbFlags | SBLF_ISTT);
+        TTfUpdNow = now;
+        if(TTsbFlags & SBLF_LMTT) {
+            TTLMTrigger = true;
+            TTFInt = 130;
+        } else {
+            TTFInt = 100 + ((int)rand_below(100) - 50);
+        }
+    }
+}
 
-                    TTClrBar = TTBarCnt = 0;
-                    TTClrBarInc = 1;
-                    TTBri = false;
+static void ttTunnelLeave(unsigned long now)
+{
+    sid.setBrightness(255);
+}
 
-                    TTLMIdx = 0;
-                    TTLMTrigger = false;
-                    
-                }
-            }
-            
-            if(TTP1) {   // Peak/"time tunnel" - runs for P1_DUR ms
-
-                if(now - TTstart < P1_DUR) {
-                    
-                    if(TTFInt && (now - TTfUpdNow >= TTFInt)) {
-                        if(TTLMTrigger) {
-                            TTLMIdx++;
-                            if(!LMTT[TTLMIdx]) TTLMIdx = 0;
-                        }
-                        showBaseLine(80, TTsbFlags | SBLF_ISTT);
-                        TTfUpdNow = now;
-                        if(TTsbFlags & SBLF_LMTT) {
-                            TTLMTrigger = true;
-                            TTFInt = 130;
-                        } else {
-                            TTFInt = 100 + ((int)(esp_random() % 100) - 50);
-                        }
-                    }
-                    
-                } else {
+// P2: Reentry
 
-                    TTP1 = false;
-                    TTP2 = true; 
+static void ttReentryEnter(unsigned long now)
+{
+    if(TTSAStopped) {
+        sa_activate(false, 500);
+        TTSAStopped = false;
+    }
+}
 
-                    sid.setBrightness(255);
+static void ttReentryRender(unsigned long now)
+{
+    if(now - TTfUpdNow >= TTFInt) {
+        TTcnt++;
+        if(TTcnt <= TT_AMP_STEPS) {
+            sa_setAmpFact(TTampFacts[TT_AMP_STEPS - 1 - TTcnt]);
+        }
+        TTfUpdNow = now;
+        TTFInt = 400 + ((int)rand_below(100) - 50);
+    }
+    sa_loop();
+}
 
-                    TTFInt = 50;
-                    TTfUpdNow = now;
-                    
-                }
-            }
-            
-            if(TTP2) {   // Reentry - up to us
+/*
+ * Frame callback: Time travel sequence and idle patterns
+ */
 
-                // Idle mode: Let showIdle take care of calming us down
-                // SA mode: reduce ampFactor gradually
+static void main_frame(unsigned long now, unsigned long delta)
+{
+    if(TTrunning) {
 
-                if(TTSAStopped) {
-                    sa_activate(false, 500);
-                    TTSAStopped = false;
-                }
-                if(saActive && sa_setAmpFact(-1) > 100) {
-                    if(now - TTfUpdNow >= TTFInt) {
-                        TTcnt++;
-                        if(TTcnt <= TT_AMP_STEPS) {
-                            sa_setAmpFact(TTampFacts[TT_AMP_STEPS - 1 - TTcnt]);
-                        }
-                        TTfUpdNow = now;
-                        TTFInt = 400 + ((int)(esp_random() % 100) - 50);
-                    }
-                    sa_loop();
-                } else {
-                    TTP2 = false;
-                    TTrunning = false;
-                    isTTKeyHeld = isTTKeyPressed = false;
-                    ssRestartTimer();
-                    sa_setAmpFact(100);
-                    LMState = LMIdx = id5idx = 0;
-                }
+        tt_frame(now);
 
-            }
+    } else if(text_busy() || startupRunning) {
 
-        }
+        // Text engine or startup sequence own display; restart 
+        // idle sequence afterwards
+        LMState = LMIdx = id5idx = 0;
+        tween_stop();
 
     } else if(!siActive && !snActive && !saActive) {    // No TT currently
 
@@ -985,8 +1068,6 @@ void main_loop()
         
         } else if(!IRLearning) {
 
-            now = millis();
-
             // "Screen saver"
             if(FPBUnitIsOn) {
                 if(!ssActive && ssDelay && (now - ssLastActivity > ssDelay)) {
@@ -1001,55 +1082,11 @@ void main_loop()
 
         }
         
-    }
-
-    // Follow TCD night mode
-    if(useNM && (tcdNM != nmOld)) {
-        if(tcdNM) {
-            // NM on: Set Screen Saver timeout to 10 seconds
-            ssDelay = 10 * 1000;
-            sidNM = true;
-        } else {
-            // NM off: End Screen Saver; reset timeout to old value
-            ssEnd();  // Doesn't do anything if fake power is off
-            ssDelay = ssOrigDelay;
-            sidNM = false;
-        }
-        nmOld = tcdNM;
-    }
-
-    now = millis();
-
-    // If network is interrupted, return to stand-alone
-    if(useBTTFN) {
-        if( (lastBTTFNpacket && (now - lastBTTFNpacket > 30*1000)) ||
-            (!BTTFNBootTO && !lastBTTFNpacket && (now - powerupMillis > 60*1000)) ) {
-            tcdNM = false;
-            tcdFPO = false;
-            gpsSpeed = -1;
-            lastBTTFNpacket = 0;
-            BTTFNBootTO = true;
-        }
-    }
+    } else {
 
-    if(!TTrunning) {
-        // Save brightness 10 seconds after last change
-        if(brichanged && (now - brichgnow > 10000)) {
-            brichanged = false;
-            saveBrightness();
-        }
-    
-        // Save idle pattern 10 seconds after last change
-        if(ipachanged && (now - ipachgnow > 10000)) {
-            ipachanged = false;
-            saveIdlePat();
-        }
-    
-        // Save irlock 10 seconds after last change
-        if(irlchanged && (now - irlchgnow > 10000)) {
-            irlchanged = false;
-            saveIRLock();
-        }
+        // Games or SA own display
+        tween_stop();
+        
     }
 }
 
@@ -1098,21 +1135,28 @@ static void showBaseLine(int variation, uint16_t flags)
                 sid.drawBar(i, 0, oldIdleHeight[i]);
             }
         } else {
+            // In tween mode, heights are keyframes; the bars are
+            // drawn by tween_frame().
+            uint8_t kf[10];
             if(!(flags & SBLF_STRICT)) {
                 for(int i = 0; i < 10; i++) {
-                    bh = a * (mods[b][i] + ((int)(esp_random() % variation)-vc)) / 100;
+                    bh = a * (mods[b][i] + ((int)rand_below(variation)-vc)) / 100;
                     if(bh < 0) bh = 0;
                     if(bh > 19) bh = 19;
                     if((flags & SBLF_LM) && bh < 9) {
-                        bh = 9 + (int)(esp_random() % 4);
+                        bh = 9 + (int)rand_below(4);
                     }
-                    if(!(flags & SBLF_ISTT) && abs(bh - oldIdleHeight[i]) > 5) {
+                    if(!(flags & (SBLF_ISTT|SBLF_TWEEN)) && abs(bh - oldIdleHeight[i]) > 5) {
                         bh = (oldIdleHeight[i] + bh) / 2;
                     }
                     if(flags & SBLF_ISTT) {
                         if(bh > maxTTHeight[i] || (!(flags & SBLF_ANIM))) bh = maxTTHeight[i];
                     }
-                    sid.drawBar(i, 0, bh);
+                    if(flags & SBLF_TWEEN) {
+                        kf[i] = bh + 1;
+                    } else {
+                        sid.drawBar(i, 0, bh);
+                    }
                     oldIdleHeight[i] = bh;
                 }
             } else {
@@ -1121,11 +1165,18 @@ static void showBaseLine(int variation, uint16_t flags)
                     if(flags & SBLF_ISTT) {
                         if(bh > maxTTHeight[i] + 1 || (!(flags & SBLF_ANIM))) bh = maxTTHeight[i] + 1;
                     }
-                    sid.drawBarWithHeight(i, bh);
+                    if(flags & SBLF_TWEEN) {
+                        kf[i] = bh;
+                    } else {
+                        sid.drawBarWithHeight(i, bh);
+                    }
                     if(bh > 0) bh--;
                     oldIdleHeight[i] = bh;
                 }
             }
+            if(flags & SBLF_TWEEN) {
+                tween_to(kf, idleDelay, IDLE_TWEEN_EASE);
+            }
         }
     
         if(flags & SBLF_ISTT) {
@@ -1146,7 +1197,7 @@ static void showBaseLine(int variation, uint16_t flags)
                 }
             }
             if(TTBri || (flags & SBLF_LMTT)) {
-                sid.setBrightnessDirect((esp_random() % 13) + 3);
+                sid.fadeTo(rand_below(13) + 3, 40, SD_EASE_INOUT);
             }
             if(flags & SBLF_LMTT) {
                 if(LMTT[TTLMIdx]) {
@@ -1158,7 +1209,7 @@ static void showBaseLine(int variation, uint16_t flags)
     }
 
     if(!(flags & SBLF_SKIPSHOW)) {
-        sid.show();
+        sid.requestShow();
     }
 
     #ifdef SID_DBG
@@ -1166,17 +1217,203 @@ static void showBaseLine(int variation, uint16_t flags)
     #endif
 }
 
+/*
+ * Idle modes
+ * 
+ * Each idle mode is a generator in idleGens[], indexed by mode 
+ * number (which is what IR, MQTT and the saved setting refer to):
+ * - delay/jitter: Interval between keyframes (ms, random +/- jitter/2)
+ * - init:   Called when the mode is selected; returns false if the
+ *           mode can't be used (eg animation file missing)
+ * - ready:  Returns false if the mode is temporarily unusable; mode 
+ *           0 is shown instead
+ * - tick:   Computes the next keyframe (baseline and/or bars); returns
+ *           flags for showBaseLine(), or -1 if there is nothing to show
+ * - render: Called on every frame, between keyframes
+ * The hooks get the entry's param. 
+ */
+
+typedef struct {
+    uint16_t delay;
+    uint16_t jitter;
+    uint8_t  param;
+    bool     (*init)(uint8_t param);
+    bool     (*ready)(uint8_t param);
+    int      (*tick)(uint8_t param, unsigned long now, bool freezeBaseLine, int& variation);
+    void     (*render)(unsigned long now);
+} idleGen;
+
+// Parameters for the baseline "random walk" of modes 0-3
+typedef struct {
+    uint8_t  blHi, blMid;     // Walk down above these baselines...
+    uint8_t  midRange;        // ...by 1-midRange when between the two
+    uint8_t  sideRange;       // Walk sideways: -1 to sideRange-2
+    uint8_t  variation;       // Bar height variation in percent
+    uint8_t  sHi;             // Strict: Walk down above this
+    uint8_t  sRange;          // Strict: Step range up/down
+} idleWalk;
+
+static const idleWalk idleWalks[2] = {
+    { 14,  8, 5, 4, 20, 30, 3 },    // Default
+    { 16, 12, 3, 5, 40, 40, 5 }     // Higher peaks
+};
+
+static int idleWalkTick(uint8_t param, unsigned long now, bool freezeBaseLine, int& variation)
+{
+    const idleWalk *w = &idleWalks[param];
+    int flags = SBLF_TWEEN;
+    
+    if(!strictMode) {
+        if(!freezeBaseLine) {
+            if(sidBaseLine > w->blHi) {
+                sidBaseLine -= (rand_below(3) + 1);
+            } else if(sidBaseLine > w->blMid) {
+                sidBaseLine -= (rand_below(w->midRange) + 1);
+            } else if(sidBaseLine < 3) {
+                sidBaseLine += (rand_below(3) + 2);
+            } else {
+                sidBaseLine += ((int)rand_below(w->sideRange) - 1);
+            }
+            variation = w->variation;
+        }
+    } else {
+        flags |= SBLF_STRICT;
+        if(!freezeBaseLine) {
+            if(strictBaseLine > w->sHi) {
+                strictBaseLine -= (rand_below(w->sRange) + 1);
+                blWayup = false;
+            } else if(strictBaseLine < 10) {
+                strictBaseLine += (rand_below(w->sRange) + 2);
+                blWayup = true;
+            } else {
+                strictBaseLine += ((int)rand_below(7) - (blWayup ? 2 : 4));
+            }
+        } else if(rand_below(5) >= 2) {
+            strictBaseLine ^= 0x01;   // toggle bit 0, nothing more
+        }
+    }
+
+    return flags;
+}
+
+// Draw intermediate frame between keyframes
+static void idleTweenRender(unsigned long now)
+{
+    if(tween_frame(now)) {
+        sid.requestShow();
+    }
+}
+
+// "Backlot mode"
+static bool idleBLInit(uint8_t param)
+{
+    id5idx = 0;
+    return true;
+}
+
+static int idleBLTick(uint8_t param, unsigned long now, bool freezeBaseLine, int& variation)
+{
+    for(int i = 0; i < 10; i++) {
+        sid.drawBarWithHeight(i, idle5[id5idx][i]);
+    }
+    id5idx++;
+    if(id5idx >= ID5_STEPS) id5idx = 0;
+    
+    sidBaseLine = strictBaseLine = 0;
+
+    return SBLF_NOBL;
+}
+
+// With masked text & "identity crisis" tt seq
+static bool idleIDCInit(uint8_t param)
+{
+    LMState = LMIdx = 0;
+    return true;
+}
+
+static int idleIDCTick(uint8_t param, unsigned long now, bool freezeBaseLine, int& variation)
+{
+    int flags = SBLF_LM | SBLF_SKIPSHOW;
+
+    if(now - lastChange2 < idleDelay2) {
+        flags |= SBLF_REPEAT;
+    } else {
+        if(!freezeBaseLine) {
+            if(sidBaseLine > 18) {
+                sidBaseLine -= (rand_below(3) + 1);
+            } else if(sidBaseLine < 3) {
+                sidBaseLine += (rand_below(3) + 2);
+            } else {
+                sidBaseLine += ((int)rand_below(5) - 1);
+            }
+            variation = 40;
+        }
+        lastChange2 = now;
+        idleDelay2 = 800 + ((int)rand_below(200) - 100);
+    }
+
+    return flags;
+}
+
+// Animation files
+static bool idleAnimInit(uint8_t param)
+{
+    return anim_start(param);
+}
+
+static bool idleAnimReady(uint8_t param)
+{
+    return anim_isActive();
+}
+
+static int idleAnimTick(uint8_t param, unsigned long now, bool freezeBaseLine, int& variation)
+{
+    if(!anim_frame(now))
+        return -1;
+
+    sidBaseLine = strictBaseLine = 0;
+
+    return SBLF_NOBL;
+}
+
+static const idleGen idleGens[] = {
+    { 800, 200, 0, NULL,        NULL,          idleWalkTick, idleTweenRender },  // 0: Default
+    { 800, 200, 1, NULL,        NULL,          idleWalkTick, idleTweenRender },  // 1: Higher peaks
+    { 300, 200, 0, NULL,        NULL,          idleWalkTick, idleTweenRender },  // 2: As 0, but faster
+    { 300, 200, 1, NULL,        NULL,          idleWalkTick, idleTweenRender },  // 3: Higher peaks, faster
+    {  90,   0, 0, idleBLInit,  NULL,          idleBLTick,   NULL            },  // 4: Backlot
+    {  80,   0, 0, idleIDCInit, NULL,          idleIDCTick,  NULL            },  // 5: Identity crisis
+    {   0,   0, 6, idleAnimInit, idleAnimReady, idleAnimTick, NULL           },  // 6-9: Animation files
+    {   0,   0, 7, idleAnimInit, idleAnimReady, idleAnimTick, NULL           },
+    {   0,   0, 8, idleAnimInit, idleAnimReady, idleAnimTick, NULL           },
+    {   0,   0, 9, idleAnimInit, idleAnimReady, idleAnimTick, NULL           }
+};
+
+static_assert(sizeof(idleGens) / sizeof(idleGens[0]) == SID_NUM_IDLE_MODES, "idleGens[] does not match SID_NUM_IDLE_MODES");
+
+static bool idleInit(int mode)
+{
+    const idleGen *g = &idleGens[mode];
+    
+    return g->init ? g->init(g->param) : true;
+}
+
 static void showIdle(bool freezeBaseLine)
 {
+    const idleGen *g = &idleGens[idleMode];
     unsigned long now = millis();
     int oldBaseLine = sidBaseLine;
     int oldSBaseLine = strictBaseLine;
     int variation = 20;
-    uint16_t sblFlags = 0;
+    int sblFlags = 0;
 
-    idleDelay2 = 800 + ((int)(esp_random() % 200) - 100);
+    if(g->ready && !g->ready(g->param)) {
+        g = &idleGens[SID_IDLE_0];
+    }
 
     if(useGPSS && gpsSpeed >= 0) {
+
+        tween_stop();
         
         if(now - lastChange < 500)
             return;
@@ -1196,209 +1433,42 @@ static void showIdle(bool freezeBaseLine)
         } else {
             if(!freezeBaseLine) {
                 strictBaseLine = gpsSpeed * 100 / (88 * 100 / (TT_SQF_LN - 1));
-                if(strictBaseLine > TT_SQF_LN-1) strictBaseLine = TT_SQF_LN-1;
-            }
-            sblFlags |= SBLF_STRICT;
-        }
-
-    } else if(idleMode == SID_IDLE_BL) {     // "backlot mode"
-
-        if(now - lastChange < idleDelay)
-            return;
-          
-        lastChange = now;
-
-        idleDelay = 90;
-
-        for(int i = 0; i < 10; i++) {
-            sid.drawBarWithHeight(i, idle5[id5idx][i]);
-        }
-        id5idx++;
-        if(id5idx >= ID5_STEPS) id5idx = 0;
-        
-        sidBaseLine = strictBaseLine = 0;
-        sblFlags |= SBLF_NOBL;
-
-    } else {
-        
-        if(now - lastChange < idleDelay)
-            return;
-          
-        lastChange = now;
-
-        if(strictMode) {
-            if(idleMode != SID_IDLE_IDC) {
-                sblFlags |= SBLF_STRICT;
-            }
-        }
-
-        switch(idleMode) {
-        case SID_IDLE_1:     // higher peaks, tempo as 0
-            idleDelay = 800 + ((int)(esp_random() % 200) - 100);
-            if(!strictMode) {
-                if(!freezeBaseLine) {
-                    if(sidBaseLine > 16) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine > 12) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine < 3) {
-                        sidBaseLine += (((esp_random() % 3)) + 2);
-                    } else {
-                        sidBaseLine += (((esp_random() % 5)) - 1);
-                    }
-                    variation = 40;
-                }
-            } else {
-                if(!freezeBaseLine) {
-                    if(strictBaseLine > 40) {
-                        strictBaseLine -= (((esp_random() % 5)) + 1);
-                        blWayup = false;
-                    } else if(strictBaseLine < 10) {
-                        strictBaseLine += (((esp_random() % 5)) + 2);
-                        blWayup = true;
-                    } else {
-                        strictBaseLine += (((esp_random() % 7)) - (blWayup ? 2 : 4));
-                    }
-                } else {
-                    if((esp_random() % 5) >= 2) {
-                        strictBaseLine ^= 0x01;   // toggle bit 0, nothing more
-                    }
-                }
-            }
-            break;
-        case SID_IDLE_2:       // Same as 0, but faster
-            idleDelay = 300 + ((int)(esp_random() % 200) - 100);
-            if(!strictMode) {
-                if(!freezeBaseLine) {
-                    if(sidBaseLine > 14) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine > 8) {
-                        sidBaseLine -= (((esp_random() % 5)) + 1);
-                    } else if(sidBaseLine < 3) {
-                        sidBaseLine += (((esp_random() % 3)) + 2);
-                    } else {
-                        sidBaseLine += (((esp_random() % 4)) - 1);
-                    }
-                }
-            } else {
-                if(!freezeBaseLine) {
-                    if(strictBaseLine > 30) {
-                        strictBaseLine -= (((esp_random() % 3)) + 1);
-                        blWayup = false;
-                    } else if(strictBaseLine < 10) {
-                        strictBaseLine += (((esp_random() % 3)) + 2);
-                        blWayup = true;
-                    } else {
-                        strictBaseLine += (((esp_random() % 7)) - (blWayup ? 2 : 4));
-                    }
-                } else {
-                    if((esp_random() % 5) >= 2) {
-                        strictBaseLine ^= 0x01;   // toggle bit 0, nothing more
-                    }
-                }
-            }
-            break;
-        case SID_IDLE_3:     // higher peaks, faster
-            idleDelay = 300 + ((int)(esp_random() % 200) - 100);
-            if(!strictMode) {
-                if(!freezeBaseLine) {
-                    if(sidBaseLine > 16) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine > 12) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine < 3) {
-                        sidBaseLine += (((esp_random() % 3)) + 2);
-                    } else {
-                        sidBaseLine += (((esp_random() % 5)) - 1);
-                    }
-                    variation = 40;
-                }
-            } else {
-                if(!freezeBaseLine) {
-                    if(strictBaseLine > 40) {
-                        strictBaseLine -= (((esp_random() % 5)) + 1);
-                        blWayup = false;
-                    } else if(strictBaseLine < 10) {
-                        strictBaseLine += (((esp_random() % 5)) + 2);
-                        blWayup = true;
-                    } else {
-                        strictBaseLine += (((esp_random() % 7)) - (blWayup ? 2 : 4));
-                    }
-                } else {
-                    if((esp_random() % 5) >= 2) {
-                        strictBaseLine ^= 0x01;   // toggle bit 0, nothing more
-                    }
-                }
-            }
-            break;
-        case SID_IDLE_IDC:   // with masked text & "identity crisis" tt seq
-            idleDelay = 80;
-            sblFlags |= (SBLF_LM|SBLF_SKIPSHOW);
-            if(now - lastChange2 < idleDelay2) {
-                sblFlags |= SBLF_REPEAT;
-            } else {
-                if(!freezeBaseLine) {
-                    if(sidBaseLine > 18) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine < 3) {
-                        sidBaseLine += (((esp_random() % 3)) + 2);
-                    } else {
-                        sidBaseLine += (((esp_random() % 5)) - 1);
-                    }
-                    variation = 40;
-                }
-                lastChange2 = now;
-                idleDelay2 = 800 + ((int)(esp_random() % 200) - 100);
-            }
-            break;
-        default:
-            idleDelay = 800 + ((int)(esp_random() % 200) - 100);
-            if(!strictMode) {
-                if(!freezeBaseLine) {
-                    if(sidBaseLine > 14) {
-                        sidBaseLine -= (((esp_random() % 3)) + 1);
-                    } else if(sidBaseLine > 8) {
-                        sidBaseLine -= (((esp_random() % 5)) + 1);
-                    } else if(sidBaseLine < 3) {
-                        sidBaseLine += (((esp_random() % 3)) + 2);
-                    } else {
-                        sidBaseLine += (((esp_random() % 4)) - 1);
-                    }
-                }
-            } else {
-                if(!freezeBaseLine) {
-                    if(strictBaseLine > 30) {
-                        strictBaseLine -= (((esp_random() % 3)) + 1);
-                        blWayup = false;
-                    } else if(strictBaseLine < 10) {
-                        strictBaseLine += (((esp_random() % 3)) + 2);
-                        blWayup = true;
-                    } else {
-                        strictBaseLine += (((esp_random() % 7)) - (blWayup ? 2 : 4));
-                    }
-                } else {
-                    if((esp_random() % 5) >= 2) {
-                        strictBaseLine ^= 0x01;   // toggle bit 0, nothing more
-                    }
-                }
+                if(strictBaseLine > TT_SQF_LN-1) strictBaseLine = TT_SQF_LN-1;
             }
-            break;
+            sblFlags |= SBLF_STRICT;
+        }
+
+    } else {
+
+        if(g->render) {
+            g->render(now);
         }
         
-        if(!freezeBaseLine) {
-            if(usingGPSS) {
-                // Smoothen
-                if(!(sblFlags & SBLF_STRICT)) {
-                    if(abs(oldBaseLine - sidBaseLine) > 3) {
-                        sidBaseLine = (sidBaseLine + oldBaseLine) / 2;
-                    }
-                } else {
-                    if(abs(oldSBaseLine - strictBaseLine) > 7) {
-                        strictBaseLine = (strictBaseLine + oldSBaseLine) / 2;
-                    }
+        if(now - lastChange < idleDelay)
+            return;
+          
+        lastChange = now;
+
+        idleDelay = g->delay;
+        if(g->jitter) {
+            idleDelay += (int)rand_below(g->jitter) - (g->jitter / 2);
+        }
+
+        if((sblFlags = g->tick(g->param, now, freezeBaseLine, variation)) < 0)
+            return;
+        
+        if(!freezeBaseLine && usingGPSS) {
+            // Smoothen
+            if(!(sblFlags & SBLF_STRICT)) {
+                if(abs(oldBaseLine - sidBaseLine) > 3) {
+                    sidBaseLine = (sidBaseLine + oldBaseLine) / 2;
+                }
+            } else {
+                if(abs(oldSBaseLine - strictBaseLine) > 7) {
+                    strictBaseLine = (strictBaseLine + oldSBaseLine) / 2;
                 }
-                usingGPSS = false;
             }
+            usingGPSS = false;
         }
     }
 
@@ -1439,7 +1509,7 @@ static void showIdle(bool freezeBaseLine)
     }
 
     if(sblFlags & SBLF_SKIPSHOW) {
-        sid.show();
+        sid.requestShow();
     }
 }
 
@@ -1453,6 +1523,10 @@ static void timeTravel(bool TCDtriggered, uint16_t P0Dur)
     if(TTrunning || IRLearning)
         return;
 
+    lat_ttStart();
+
+    text_abort();
+
     bool initScreen = siActive || snActive;
 
     siddly_stop();
@@ -1465,7 +1539,7 @@ static void timeTravel(bool TCDtriggered, uint16_t P0Dur)
         
     TTrunning = true;
     TTstart = TTfUpdNow = millis();
-    TTP0 = true;   // phase 0
+    TTphase = 0;   // P0
     TTSAStopped = false;
     TTsbFlags = skipTTAnim ? 0 : SBLF_ANIM;
     TTLMIdx = 0;
@@ -1496,43 +1570,30 @@ static void timeTravel(bool TCDtriggered, uint16_t P0Dur)
         }
     }
     
-    if(TCDtriggered) {    // TCD-triggered TT (GPIO, BTTFN or MQTT) (synced with TCD)
-        extTT = true;
-        P0duration = P0Dur;
-        #ifdef SID_DBG
-        Serial.printf("P0 duration is %d\n", P0duration);
-        #endif
-        if(TTcnt > 0) {
-            if(P0duration > 2500) {
-                TTFDelay = P0duration - 2500;
-            } else {
-                TTFDelay = 0;
-            }
-            TTFInt = (P0duration - TTFDelay) / (TTcnt + 1);
-            if(TTFInt > 0 && TTFInt < 65) {
-                if((TTcnt + 1) * 65 <= P0duration) {
-                    TTFInt = 65;
-                    TTFDelay = P0duration - (TTFInt * (TTcnt + 1));
-                }
-            }
+    // TCD-triggered TT (GPIO, BTTFN or MQTT) is synced with TCD,
+    // button/IR-triggered TT (stand-alone) uses our own P0 duration
+    extTT = TCDtriggered;
+    P0duration = TCDtriggered ? P0Dur : P0_DUR;
+    #ifdef SID_DBG
+    Serial.printf("P0 duration is %d\n", P0duration);
+    #endif
+    
+    if(TTcnt > 0) {
+        if(P0duration > 2500) {
+            TTFDelay = P0duration - 2500;
         } else {
-            TTFInt = 0;
             TTFDelay = 0;
         }
-    } else {              // button/IR-triggered TT (stand-alone)
-        extTT = false;
-        TTFDelay = 2500;
-        if(TTcnt > 0) {
-            TTFInt = (P0_DUR - TTFDelay) / (TTcnt + 1);
-            if(TTFInt > 0 && TTFInt < 65) {
-                if((TTcnt + 1) * 65 <= P0_DUR) {
-                    TTFInt = 65;
-                    TTFDelay = P0_DUR - (TTFInt * (TTcnt + 1));
-                }
+        TTFInt = (P0duration - TTFDelay) / (TTcnt + 1);
+        if(TTFInt > 0 && TTFInt < 65) {
+            if((TTcnt + 1) * 65 <= P0duration) {
+                TTFInt = 65;
+                TTFDelay = P0duration - (TTFInt * (TTcnt + 1));
             }
-        } else {
-            TTFInt = 0;
         }
+    } else {
+        TTFInt = 0;
+        TTFDelay = 0;
     }
     
     #ifdef SID_DBG
@@ -1540,7 +1601,12 @@ static void timeTravel(bool TCDtriggered, uint16_t P0Dur)
     #endif
 }
 
-static void play_startup()
+/*
+ * Startup sequence
+ * Runs as scheduled task; done() is called when finished.
+ */
+
+static long startupTask(int step)
 {
     const uint8_t q[10] = {
         27, 26, 20, 27, 20, 25, 28, 20, 25, 28
@@ -1551,74 +1617,115 @@ static void play_startup()
     const uint8_t q4[10] = {
         20, 20, 20, 20, 20, 27, 27, 27, 27, 27
     };
-    uint8_t w[10];
-    uint8_t oldBri = sid.getBrightness();
+    int i;
 
-    sid.clearBuf();
-    sid.clearDisplayDirect();
-
-    sid.setBrightnessDirect(0);
+    if(step == 0) {
+        startupBri = sid.getBrightness();
+        sid.clearBuf();
+        sid.clearDisplayDirect();
+        sid.setBrightnessDirect(0);
+    }
 
-    // Growing line
-    for(int i = 0; i < 5; i++) {
+    // Growing line (steps 0-4), pause (step 5)
+    if(step < 5) {
+        i = step;
         sid.drawDot(4 - i, 10);
         sid.drawDot(5 + i, 10);
         sid.show();
-        if(oldBri >= (i + 1) * 2) sid.setBrightnessDirect((i + 1) * 2);
-        mydelay(20 - (i*2), false);
+        if(startupBri >= (i + 1) * 2) sid.setBrightnessDirect((i + 1) * 2);
+        return 20 - (i*2);
+    } else if(step == 5) {
+        if(startupBri >= 12) sid.setBrightnessDirect(12);
+        return 50;
     }
 
-    if(oldBri >= 12) sid.setBrightnessDirect(12);
-    
-    mydelay(50, false);
-    
-    sid.setBrightness(255);
-
-    // Fill from center
-    for(int i = 0; i < 10; i++) {
+    // Fill from center (steps 6-15)
+    if(step < 16) {
+        i = step - 6;
+        if(!i) sid.setBrightness(255);
         for(int j = 0; j < 10; j++) {
             sid.drawBar(j, 10 - i, 10 + i);
         }
         sid.show();
-        mydelay(30 - (i*2), false);
-    }
-    
-    for(int i = 0; i < 10; i++) {
-        oldIdleHeight[i] = 0;
+        return 30 - (i*2);
     }
-    
-    // Shrink like idle pattern
-    if(idleMode == SID_IDLE_BL) {
-        memcpy(w, q4, sizeof(w));
-    } else if(strictMode && idleMode != SID_IDLE_IDC) {
-        memcpy(w, qs, sizeof(w));
-    } else {
-        memcpy(w, q, sizeof(w));
-    }
-    for(int i = 0; i < 28/2; i++) {
+
+    // Shrink like idle pattern (steps 16-29)
+    if(step < 16 + 28/2) {
+        i = step - 16;
+        if(!i) {
+            for(int j = 0; j < 10; j++) {
+                oldIdleHeight[j] = 0;
+            }
+            if(idleMode == SID_IDLE_BL) {
+                memcpy(startupW, q4, sizeof(startupW));
+            } else if(strictMode && idleMode != SID_IDLE_IDC) {
+                memcpy(startupW, qs, sizeof(startupW));
+            } else {
+                memcpy(startupW, q, sizeof(startupW));
+            }
+        }
         for(int j = 0; j < 10; j++) {
-            sid.drawBarWithHeight(j, w[j]);
-            if(w[j] >= 2) w[j] -= 2;
+            sid.drawBarWithHeight(j, startupW[j]);
+            if(startupW[j] >= 2) startupW[j] -= 2;
         }
         sid.show();
-        mydelay(30 + (i*5), false);
+        return 30 + (i*5);
     }
+
+    startupRunning = false;
+    if(startupDone) startupDone();
+    
+    return SCHED_DONE;
+}
+
+static void play_startup(void (*done)())
+{
+    startupDone = done;
+    startupRunning = true;
+    sched_add(startupTask);
+}
+
+static void stop_startup()
+{
+    sched_cancel(startupTask);
+    startupRunning = false;
 }
 
-void setIdleMode(int idleNo)
+// Fake power on: Startup sequence finished
+static void powerOnDone()
 {
-    uint16_t temp = idleMode;
+    ssRestartTimer();
+
+    // Restore sa mode if active before FPO
+    if(FPOSAMode > 0) {
+        span_start();
+    }
+}
+
+bool setIdleMode(int idleNo)
+{
+    if(idleNo < 0 || idleNo >= SID_NUM_IDLE_MODES)
+        return false;
+
+    if(!idleInit(idleNo)) {
+        // Re-init current mode (init might have interfered)
+        idleInit(idleMode);
+        return false;
+    }
+
+    if(idleNo < SID_IDLE_ANIM) {
+        anim_stop();
+    }
+    tween_stop();
     
     idleMode = idleNo;
-    if(temp != idleMode) {
-        if(idleMode == SID_IDLE_IDC) {
-            LMState = LMIdx = 0;
-        } else if(idleMode == SID_IDLE_BL) {
-            id5idx = 0;
-        }
-    }
+    lastChange = 0;
+    
     ipachanged = true;
     ipachgnow = millis();
+
+    return true;
 }
 
 static void toggleStrictMode()
@@ -1643,6 +1750,12 @@ static void endIRfeedback()
     digitalWrite(IRFeedBackPin, LOW);
 }
 
+static long irFeedbackEndTask(int step)
+{
+    endIRfeedback();
+    return SCHED_DONE;
+}
+
 static void backupIR()
 {
     for(int i = 0; i < NUM_IR_KEYS; i++) {
@@ -1657,17 +1770,22 @@ static void restoreIRbackup()
     }
 }
 
+static void showLearnKey()
+{
+    if(IRLearning) {
+        showChar(IRLearnKeys[IRLearnIndex]);
+    }
+}
+
 static void startIRLearn()
 {
     // Play LEARN START sequence
-    showWordSequence("GO", 4);
+    showWordSequence("GO", 4, showLearnKey);
     IRLearning = true;
     IRLearnIndex = 0;
     IRLearnNow = IRFBLearnNow = millis();
     IRLearnBlink = false;
     backupIR();
-    showChar(IRLearnKeys[IRLearnIndex]);
-    ir_remote.loop();     // Ignore IR received in the meantime
 }
 
 static void endIRLearn(bool restore)
@@ -1678,16 +1796,78 @@ static void endIRLearn(bool restore)
     if(restore) {
         restoreIRbackup();
     }
-    ir_remote.loop();     // Ignore IR received in the meantime
+    buildIRMap();
+    ir_remote.resume();   // Ignore IR received in the meantime
+}
+
+/*
+ * IR code lookup
+ * 
+ * All codes in remote_codes (of the first maxIRctrls remotes) are 
+ * entered into a hash map, so that a received code is found in 
+ * constant time. The map needs to be rebuilt after any change to
+ * remote_codes or maxIRctrls. Code 0 means "unused".
+ * If a code is assigned to more than one key, the lowest key wins.
+ */
+
+static uint32_t irMapSlot(uint32_t code)
+{
+    // Fibonacci hashing; codes are FNV hashes already, but
+    // user-provided ones might not be
+    return (code * 2654435769UL) >> IR_MAP_SHIFT;
+}
+
+static void buildIRMap()
+{
+    memset(irMapCodes, 0, sizeof(irMapCodes));
+
+    for(int i = 0; i < NUM_IR_KEYS; i++) {
+        for(int j = 0; j < maxIRctrls; j++) {
+            uint32_t code = remote_codes[i][j];
+            uint32_t k;
+            if(!code) continue;
+            for(k = irMapSlot(code); irMapCodes[k]; k = (k + 1) & (IR_MAP_SIZE - 1)) {
+                if(irMapCodes[k] == code) break;
+            }
+            if(!irMapCodes[k]) {
+                irMapCodes[k] = code;
+                irMapKeys[k] = i;
+            }
+        }
+    }
+}
+
+static int lookupIRKey(uint32_t code)
+{
+    if(code) {
+        for(uint32_t k = irMapSlot(code); irMapCodes[k]; k = (k + 1) & (IR_MAP_SIZE - 1)) {
+            if(irMapCodes[k] == code) return irMapKeys[k];
+        }
+    }
+    
+    return -1;
 }
 
 static void handleIRinput()
 {
     uint32_t myHash = ir_remote.readHash();
-    uint16_t i, j;
-    bool done = false;
+    int key;
     
+    // Repeat frame (held key): Keep key down for auto-repeat
+    if(ir_remote.readCode().repeat) {
+        if(irKeyDown && myHash == irHeldHash) {
+            irHeldLast = ir_remote.readEndTime();
+        }
+        return;
+    }
+
+    #ifdef SID_DBG
     Serial.printf("handleIRinput: Received IR code 0x%lx\n", myHash);
+    if(ir_remote.readCode().protocol != IRPROTO_UNKNOWN) {
+        Serial.printf("handleIRinput: Protocol %d, address 0x%x, command 0x%x\n",
+            ir_remote.readCode().protocol, ir_remote.readCode().address, ir_remote.readCode().command);
+    }
+    #endif
 
     if(IRLearning) {
         endIRfeedback();
@@ -1703,8 +1883,7 @@ static void handleIRinput()
             #endif
         } else {
             // Play LEARN NEXT sequence
-            fadeOutChar();
-            showChar(IRLearnKeys[IRLearnIndex]);
+            fadeOutChar(showLearnKey);
             #ifdef SID_DBG
             Serial.println("handleIRinput: IR key learned");
             #endif
@@ -1717,18 +1896,95 @@ static void handleIRinput()
         return;
     }
 
-    for(i = 0; i < NUM_IR_KEYS; i++) {
-        for(j = 0; j < maxIRctrls; j++) {
-            if(remote_codes[i][j] == myHash) {
-                #ifdef SID_DBG
-                Serial.printf("handleIRinput: key %d\n", i);
-                #endif
-                handleIRKey(i);
-                done = true;
-                break;
-            }
+    if((key = lookupIRKey(myHash)) >= 0) {
+        #ifdef SID_DBG
+        Serial.printf("handleIRinput: key %d\n", key);
+        #endif
+        irHeldKey = key;
+        irHeldHash = myHash;
+        irKeyDown = true;
+        irHeldLast = ir_remote.readEndTime();
+        irNextRepeat = irHeldLast + SID_IR_REPEAT_DELAY * 1000;
+        handleIRKey(key);
+    } else {
+        irHeldKey = -1;
+        irKeyDown = false;
+    }
+}
+
+/*
+ * IR key auto-repeat
+ * 
+ * A key is held as long as the remote sends repeat frames (NEC
+ * repeat codes, repeated SIRC/RC5/RC6 frames); it counts as released
+ * when no frame ended within IR_RELEASE_TO. While held, the key 
+ * repeats after SID_IR_REPEAT_DELAY every SID_IR_REPEAT_RATE ms, 
+ * independent of the remote's frame rate. Remotes whose protocol is
+ * unknown send no recognizable repeat frames; their keys do not
+ * repeat.
+ */
+static void irKeyLoop()
+{
+    unsigned long now;
+    
+    if(!irKeyDown)
+        return;
+
+    now = micros();
+        
+    if(now - irHeldLast > IR_RELEASE_TO) {
+        irKeyDown = false;
+        return;
+    }
+
+    if((long)(now - irNextRepeat) >= 0) {
+        irNextRepeat += SID_IR_REPEAT_RATE * 1000;
+        if((long)(now - irNextRepeat) >= 0) {
+            irNextRepeat = now + SID_IR_REPEAT_RATE * 1000;
+        }
+        if(!text_busy() && !startupRunning && !IRLearning) {
+            handleIRKeyRepeat(irHeldKey);
+        }
+    }
+}
+
+// Auto-repeat: Game moves and brightness only. These are
+// executed directly, with no IR feedback.
+static void handleIRKeyRepeat(int key)
+{
+    if(irLocked || ssActive || inputRecord)
+        return;
+
+    ssRestartTimer();
+    lastKeyPressed = millis();
+    
+    switch(key) {
+    case 12:                          // arrow up: inc brightness
+        if(!siActive && !snActive && !saActive) {
+            inc_bri();
+            brichanged = true;
+            brichgnow = lastKeyPressed;
+        }
+        break;
+    case 13:                          // arrow down: dec brightness  si: move down
+        if(siActive) {
+            si_moveDown();
+        } else if(!snActive && !saActive) {
+            dec_bri();
+            brichanged = true;
+            brichgnow = lastKeyPressed;
+        }
+        break;
+    case 14:                          // arrow left:                 si: move left
+        if(siActive) {
+            si_moveLeft();
+        }
+        break;
+    case 15:                          // arrow right:                si: move right
+        if(siActive) {
+            si_moveRight();
         }
-        if(done) break;
+        break;
     }
 }
 
@@ -2029,7 +2285,9 @@ static bool execute(bool isIR)
             case 3:
             case 4:
             case 5:
-                setIdleMode(inputBuffer[0] - '0');
+                if(!setIdleMode(inputBuffer[0] - '0')) {
+                    doBadInp = true;
+                }
                 break;
             default:
                 doBadInp = true;
@@ -2038,11 +2296,9 @@ static bool execute(bool isIR)
         break;
     case 2:
         temp = atoi(inputBuffer);
-        if(temp >= 10 && temp <= 19) {            // *10-*15 idle pattern
+        if(temp >= 10 && temp <= 19) {            // *10-*19 idle pattern
             if(!isIRLocked) {
-                if(temp <= (10 + SID_MAX_IDLE_MODE)) {
-                    setIdleMode(temp - 10);
-                } else {
+                if(!setIdleMode(temp - 10)) {
                     doBadInp = true;
                 }
             }
@@ -2080,6 +2336,23 @@ static bool execute(bool isIR)
                     snake_start();
                 }
                 break;
+            case 24:                              // *24 siddly demo
+                if(!TTrunning && !isIRLocked) {
+                    span_stop();
+                    snake_stop();
+                    siddly_start(true);
+                }
+                break;
+            case 26:                              // *26-*29 record SA to idle pattern 6-9
+            case 27:
+            case 28:
+            case 29:
+                if(!TTrunning && !isIRLocked) {
+                    if(!toggleRecording(temp - 20)) {
+                        doBadInp = true;
+                    }
+                }
+                break;
             case 50:                              // *50  enable/disable strict mode
                 if(!TTrunning && !isIRLocked) {
                     toggleStrictMode();
@@ -2113,7 +2386,6 @@ static bool execute(bool isIR)
                     siddly_stop();
                     snake_stop();
                     showWordSequence(ipbuf, 5);
-                    ir_remote.loop(); // Flush IR afterwards
                 }
                 break;
             default:
@@ -2153,6 +2425,7 @@ static bool execute(bool isIR)
                     for(int i = 0; i < NUM_IR_KEYS; i++) {
                         remote_codes[i][1] = 0;
                     }
+                    buildIRMap();
                 } else {
                     doBadInp = true;
                 }
@@ -2181,6 +2454,8 @@ static void span_start()
 
 static void span_stop(bool skipClearDisplay)
 {
+    stopRecording();
+    
     if(saActive) {
         sa_deactivate();
         if(skipClearDisplay) {
@@ -2190,10 +2465,66 @@ static void span_stop(bool skipClearDisplay)
     }
 }
 
-static void siddly_start()
+/*
+ * Record SA output as idle pattern (animation file). If that 
+ * pattern is currently selected, its file is closed while
+ * recording, and re-opened once the file is written.
+ */
+
+static long recReopenTask(int step)
+{
+    if(rec_isBusy())
+        return 100;
+
+    if(idleMode >= SID_IDLE_ANIM && !anim_isActive()) {
+        anim_start(idleMode);
+    }
+
+    return SCHED_DONE;
+}
+
+static bool toggleRecording(int num)
+{
+    if(rec_isActive()) {
+        stopRecording();
+        return true;
+    }
+
+    if(!saActive) {
+        siddly_stop();
+        snake_stop();
+        span_start();
+        // No mic (or i2s failed): Nothing to record
+        if(!saActive)
+            return false;
+    }
+
+    if(idleMode == num) {
+        anim_stop();
+    }
+
+    if(!rec_start(num)) {
+        if(idleMode == num) {
+            anim_start(idleMode);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+static void stopRecording()
+{
+    if(rec_isActive()) {
+        rec_stop();
+        sched_add(recReopenTask, 100);
+    }
+}
+
+static void siddly_start(bool demo)
 {
     sid.clearDisplayDirect();
-    si_init();
+    si_init(demo);
 }
 
 static void siddly_stop()
@@ -2272,58 +2603,18 @@ void allOff()
     sid.clearDisplayDirect();
 }
 
-static void fadeOut()
-{
-    int a = sid.getBrightness();
-    while(a >= 0) {
-        sid.setBrightnessDirect(a);
-        a--;
-        mydelay(10, false);
-    }
-}
-
-void showWordSequence(const char *text, int speed)
-{
-    const int speedDelay[6] = { 100, 200, 300, 400, 500, 1000 };
-
-    if(speed < 0) speed = 0;
-    if(speed > 5) speed = 5;
-    
-    sid.clearDisplayDirect();
-    for(int i = 0; i < strlen(text); i++) {
-        sid.drawLetterAndShow(text[i], 0, 8);
-        sid.setBrightness(255);
-        mydelay(speedDelay[speed], false);
-        fadeOut();
-        mydelay(50, false);
-    }
-    sid.clearDisplayDirect();
-    sid.setBrightness(255);
-    LMState = LMIdx = id5idx = 0;
-    ir_remote.loop();     // Ignore IR received in the meantime
-}
-
 static void showChar(const char text)
 {
     sid.clearDisplayDirect();
     sid.drawLetterAndShow(text, 0, 8);
 }
 
-static void fadeOutChar()
-{
-    fadeOut();
-    mydelay(50, false);
-    sid.clearDisplayDirect();
-    sid.setBrightness(255);
-    LMState = LMIdx = id5idx = 0;
-    ir_remote.loop();     // Ignore IR received in the meantime
-}
-
 void populateIRarray(uint32_t *irkeys, int index)
 {
     for(int i = 0; i < NUM_IR_KEYS; i++) {
         remote_codes[i][index] = irkeys[i]; 
     }
+    buildIRMap();
 }
 
 void copyIRarray(uint32_t *irkeys, int index)
@@ -2351,13 +2642,18 @@ static void TTKeyHeld()
 }
 
 // "Screen saver"
+static void ssFadedOut()
+{
+    sid.off();
+}
+
 static void ssStart()
 {
     if(ssActive)
         return;
 
-    // Display off
-    sid.off();
+    // Fade out, then display off
+    sid.fadeOut(SS_FADE_OUT, SD_EASE_IN, ssFadedOut);
 
     ssActive = true;
 }
@@ -2378,6 +2674,7 @@ static void ssEnd()
         return;
 
     sid.on();
+    sid.fadeIn(SS_FADE_IN, SD_EASE_OUT);
 
     ssActive = false;
 }
@@ -2400,34 +2697,6 @@ void wakeup()
     ssEnd();
 }
 
-/*
- *  Do this whenever we are caught in a while() loop
- *  This allows other stuff to proceed
- *  withIR is needed for shorter delays; it allows
- *  filtering out repeated keys. If IR is flushed
- *  after the delay, withIR is not needed.
- */
-static void myloop(bool withIR)
-{
-    wifi_loop();
-    if(withIR) ir_remote.loop();
-}
-
-/*
- * MyDelay:
- * Calls myloop() periodically
- */
-void mydelay(unsigned long mydel, bool withIR)
-{
-    unsigned long startNow = millis();
-    myloop(withIR);
-    while(millis() - startNow < mydel) {
-        delay(10);
-        myloop(withIR);
-    }
-}
-
-
 /*
  * BTTF network communication
  */
@@ -2548,6 +2817,7 @@ static void BTTFNCheckPacket()
                 networkReentry = false;
                 networkAbort = false;
                 networkLead = BTTFUDPBuf[6] | (BTTFUDPBuf[7] << 8);
+                lat_received(LAT_SRC_BTTFN);
             }
             break;
         case BTTFN_NOT_REENTRY:
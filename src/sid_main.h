@@ -38,7 +38,8 @@ extern unsigned long powerupMillis;
 
 extern sidDisplay sid;
 
-#define SID_MAX_IDLE_MODE 5
+#define SID_NUM_IDLE_MODES 10    // Number of entries in idle mode registry
+#define SID_MAX_IDLE_MODE  (SID_NUM_IDLE_MODES - 1)
 extern uint16_t idleMode;
 extern bool     strictMode;
 
@@ -73,14 +74,10 @@ void allOff();
 void populateIRarray(uint32_t *irkeys, int index);
 void copyIRarray(uint32_t *irkeys, int index);
 
-void showWordSequence(const char *text, int speed = 3);
-
-void mydelay(unsigned long mydel, bool withIR);
-
 void prepareTT();
 void wakeup();
 
-void setIdleMode(int idleNo);
+bool setIdleMode(int idleNo);
 
 void switch_to_idle();
 void switch_to_sa();
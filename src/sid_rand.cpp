@@ -0,0 +1,90 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Random numbers: Fast PRNG for animations
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+
+#include "sid_rand.h"
+
+/*
+ * All animations (idle patterns, TT sequence, games) take their 
+ * random numbers from here instead of calling esp_random(), which
+ * reads the hardware RNG register each time. This is a xorshift32 
+ * generator, seeded once at boot from esp_random(). If SID_RAND_SEED
+ * is defined (or a seed is set through rand_setSeed()), the sequence 
+ * of numbers - and thereby all animations - can be reproduced. 
+ */
+
+static uint32_t randSeed  = 1;
+static uint32_t randState = 1;
+
+void rand_setup()
+{
+    #ifdef SID_RAND_SEED
+    rand_setSeed(SID_RAND_SEED);
+    #else
+    rand_setSeed(esp_random());
+    #endif
+
+    #ifdef SID_DBG
+    Serial.printf("Random seed: 0x%08x\n", randSeed);
+    #endif
+}
+
+void rand_setSeed(uint32_t seed)
+{
+    // xorshift must not be seeded with 0
+    randSeed = randState = seed ? seed : 0x2545f491;
+}
+
+uint32_t rand_getSeed()
+{
+    return randSeed;
+}
+
+uint32_t rand_next()
+{
+    uint32_t x = randState;
+    
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    
+    return (randState = x);
+}
+
+// Returns 0 - n-1; multiply-shift instead of (slow) modulo
+uint32_t rand_below(uint32_t n)
+{
+    return (uint32_t)(((uint64_t)rand_next() * n) >> 32);
+}
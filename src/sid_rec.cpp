@@ -0,0 +1,307 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Recorder: Spectrum Analyzer output to animation file
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "sid_rec.h"
+#include "sid_anim.h"
+#include "sid_settings.h"
+
+/*
+ * Records the bar heights calculated by the Spectrum Analyzer into
+ * an animation file on SD ("/idleN.sda", see sid_anim.cpp), which
+ * can then be played back as idle mode N - without mic, i2s or FFT.
+ * 
+ * Each analyzer result becomes an ANIM_PACKED frame (5 bits per 
+ * bar), its duration being the time until the next result. The 
+ * recording loops from the start.
+ * 
+ * Frames are put in a ring buffer and written to the file by a 
+ * background task, so slow SD writes don't stall the main loop.
+ * The buffer is shared between cores (main loop on core 1, writer
+ * on core 0): The index a side publishes is stored with release 
+ * semantics after its buffer accesses, and the other side loads it 
+ * with acquire semantics before touching the buffer.
+ * 
+ * The recording goes to "/idleN.tmp", which replaces the animation
+ * only once it is complete (header, at least one frame, ANIM_END);
+ * otherwise it is deleted and the old animation is kept.
+ */
+
+#define REC_WRITE_CHUNK  128    // Wake writer when this much is buffered
+
+static File           recFile;
+static bool           recActive = false;
+static volatile bool  recBusy = false;      // File open (writer not done)
+static volatile bool  recStopReq = false;
+static volatile bool  recComplete = false;  // Stopped with frame(s) and ANIM_END
+
+static uint8_t           recBuf[REC_BUF_SIZE];
+static volatile uint16_t recHead = 0;       // Written by main task
+static volatile uint16_t recTail = 0;       // Written by writer task
+
+static TaskHandle_t   recTaskHandle = NULL;
+
+static uint8_t        recBars = 0;
+static uint8_t        recPend[ANIM_MAX_BARS];
+static bool           recHavePend = false;
+static unsigned long  recPendNow = 0;
+static uint8_t        recLastDur = 3;
+static unsigned long  recStart = 0;
+static uint32_t       recEmitted = 0;
+static char           recFn[16];
+static char           recTmpFn[16];
+
+#ifdef SID_DBG
+static unsigned long  recFrames = 0;
+static unsigned long  recDropped = 0;
+#endif
+
+static void recTask(void *arg);
+
+static uint16_t recFree()
+{
+    uint16_t t = __atomic_load_n(&recTail, __ATOMIC_ACQUIRE);
+    
+    return (t - recHead - 1) & (REC_BUF_SIZE - 1);
+}
+
+static bool recPut(const uint8_t *data, uint16_t len)
+{
+    uint16_t h = recHead;
+
+    if(recFree() < len)
+        return false;
+
+    for(int i = 0; i < len; i++) {
+        recBuf[h] = data[i];
+        h = (h + 1) & (REC_BUF_SIZE - 1);
+    }
+    // Buffer contents must be visible to writer before the index
+    __atomic_store_n(&recHead, h, __ATOMIC_RELEASE);
+
+    if(((h - recTail) & (REC_BUF_SIZE - 1)) >= REC_WRITE_CHUNK) {
+        xTaskNotifyGive(recTaskHandle);
+    }
+
+    return true;
+}
+
+// Queue pending frame with given duration (10ms units)
+static void recEmit(uint8_t dur)
+{
+    uint8_t frame[2 + ANIM_PACKED_SIZE(ANIM_MAX_BARS)] = { ANIM_PACKED, dur };
+    uint32_t bits = 0;
+    int nbits = 0, idx = 2;
+
+    for(int i = 0; i < recBars; i++) {
+        bits |= (uint32_t)(recPend[i] & 0x1f) << nbits;
+        nbits += 5;
+        while(nbits >= 8) {
+            frame[idx++] = bits & 0xff;
+            bits >>= 8;
+            nbits -= 8;
+        }
+    }
+    if(nbits) {
+        frame[idx++] = bits & 0xff;
+    }
+
+    if(!recPut(frame, idx)) {
+        #ifdef SID_DBG
+        recDropped++;
+        #endif
+    } else {
+        recEmitted++;
+        #ifdef SID_DBG
+        recFrames++;
+        #endif
+    }
+}
+
+bool rec_start(int num)
+{
+    if(recActive || recBusy)
+        return false;
+
+    if(!recTaskHandle) {
+        if(xTaskCreatePinnedToCore(recTask, "SIDRec", 3072, NULL, 1, 
+                                   &recTaskHandle, 0) != pdPASS) {
+            recTaskHandle = NULL;
+            #ifdef SID_DBG
+            Serial.println("rec_start: Failed to create writer task");
+            #endif
+            return false;
+        }
+    }
+
+    sprintf(recFn, "/idle%d.sda", num);
+    sprintf(recTmpFn, "/idle%d.tmp", num);
+
+    if(!openDataFileWrite(recTmpFn, recFile)) {
+        #ifdef SID_DBG
+        Serial.printf("rec_start: Failed to open %s\n", recTmpFn);
+        #endif
+        return false;
+    }
+
+    // Header is queued with the first frame (number of bars)
+    recHead = recTail = 0;
+    recBars = 0;
+    recHavePend = false;
+    recLastDur = 3;
+    recStart = millis();
+    recEmitted = 0;
+    recStopReq = recComplete = false;
+    recBusy = recActive = true;
+
+    #ifdef SID_DBG
+    recFrames = recDropped = 0;
+    Serial.printf("rec: Recording to %s\n", recTmpFn);
+    #endif
+
+    return true;
+}
+
+void rec_stop()
+{
+    uint8_t end = ANIM_END;
+    
+    if(!recActive)
+        return;
+
+    // Without any analyzer result, there is no header and no frame
+    if(recHavePend) {
+        recEmit(recLastDur);
+        recComplete = (recEmitted > 0) && recPut(&end, 1);
+    }
+    
+    recActive = false;
+    __atomic_store_n(&recStopReq, true, __ATOMIC_RELEASE);
+    xTaskNotifyGive(recTaskHandle);
+
+    #ifdef SID_DBG
+    Serial.printf("rec: Stopped; %lu frames, %lu dropped\n", recFrames, recDropped);
+    #endif
+}
+
+bool rec_isActive()
+{
+    return recActive;
+}
+
+// True until the file is completely written and closed
+bool rec_isBusy()
+{
+    return recBusy;
+}
+
+/*
+ * Called by the Spectrum Analyzer for each new set of bar heights
+ */
+void rec_frame(const int *heights, int numBars, unsigned long now)
+{
+    unsigned long dur;
+    
+    if(!recActive)
+        return;
+
+    if(numBars > ANIM_MAX_BARS) numBars = ANIM_MAX_BARS;
+
+    if(!recBars) {
+        // Loop point is frame 0
+        uint8_t hdr[ANIM_HDR_SIZE] = { 'S', 'I', 'D', 'A', ANIM_VERSION, (uint8_t)numBars, 0, 0 };
+        recBars = numBars;
+        recPut(hdr, ANIM_HDR_SIZE);
+    }
+
+    if(recHavePend) {
+        dur = (now - recPendNow + 5) / 10;
+        if(dur > 255) dur = 255;
+        recLastDur = dur;
+        recEmit(recLastDur);
+    }
+
+    for(int i = 0; i < recBars; i++) {
+        recPend[i] = (heights[i] < 0) ? 0 : heights[i];
+    }
+    recPendNow = now;
+    recHavePend = true;
+
+    if(now - recStart >= REC_MAX_DUR) {
+        rec_stop();
+    }
+}
+
+/*
+ * Background writer
+ */
+static void recTask(void *arg)
+{
+    uint16_t head, tail, len;
+    bool stop;
+    
+    for(;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(500));
+
+        if(!recBusy)
+            continue;
+
+        // Stop request first: Everything queued before it is then
+        // covered by the head index loaded below
+        stop = __atomic_load_n(&recStopReq, __ATOMIC_ACQUIRE);
+        
+        head = __atomic_load_n(&recHead, __ATOMIC_ACQUIRE);
+        tail = recTail;
+        while(tail != head) {
+            len = (head > tail) ? head - tail : REC_BUF_SIZE - tail;
+            recFile.write(&recBuf[tail], len);
+            tail = (tail + len) & (REC_BUF_SIZE - 1);
+            // Done reading before the space is handed back
+            __atomic_store_n(&recTail, tail, __ATOMIC_RELEASE);
+        }
+
+        if(stop) {
+            recFile.close();
+            if(recComplete) {
+                renameDataFile(recTmpFn, recFn);
+            } else {
+                removeDataFile(recTmpFn);
+            }
+            recStopReq = false;
+            recBusy = false;
+        }
+    }
+}
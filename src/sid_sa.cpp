@@ -37,6 +37,8 @@
 #include <driver/adc.h>
 #include <soc/i2s_reg.h>
 #include "sid_main.h"
+#include "sid_text.h"
+#include "sid_rec.h"
 
 #define NUMBANDS      11    // Number of bands ("bins" in FFT-speak)
 #define DISPLAYBANDS  10    // Displayed number of bands
@@ -84,6 +86,7 @@ static const uint8_t maxTTHeight[10] = {
 
 static int oldHeight[DISPLAYBANDS]  = { 0 };
 
+static bool          saDraw = false;
 static uint8_t       peaks[DISPLAYBANDS]     = { 0 };
 static unsigned long newPeak[DISPLAYBANDS]   = { 0 };
 static unsigned long peakTimer[DISPLAYBANDS] = { 0 };
@@ -330,12 +333,9 @@ void sa_loop()
                     newPeak[i] = now;
                     peakTimer[i] = PEAK_HOLD;
                     oldHeight[i] = 1;
-                    if(initDisplay) {
-                        sid.drawBarWithHeight(i, 1);
-                    }
                 }
                 if(initDisplay) {
-                    sid.show();
+                    saDraw = true;
                 }
                 initFlag = true;
             }
@@ -378,19 +378,23 @@ void sa_loop()
             }
         
             oldHeight[i] = height;
-
-            // Draw bars & peaks
-            sid.drawBarWithHeight(i, oldHeight[i]);
-            if(doPeaks && peaks[i] > oldHeight[i] - 1) {
-                sid.drawDot(i, peaks[i]);
-            }
         }
 
-        // Put result on display
-        sid.show();
+        // Put result on display at next frame
+        saDraw = true;
+
+        rec_frame(oldHeight, DISPLAYBANDS, now);
     }
 
-    now = millis();
+    #endif
+}
+
+// The frame callback: Let peaks fall, draw bars & peaks
+
+void sa_frame(unsigned long now, unsigned long delta)
+{
+    if(!saActive || !sa_avail)
+        return;
 
     // Make peaks fall down
     for(int i = 0; i < DISPLAYBANDS; i++) {
@@ -399,11 +403,27 @@ void sa_loop()
                 peakTimer[i] = PEAK_FALL;
                 newPeak[i] = now;
                 peaks[i]--;
+                if(doPeaks && !startFlag) saDraw = true;
             } else {
                 newPeak[i] = 0;
             }
         }
     }
 
-    #endif
+    // Text engine owns display; redraw when done
+    if(!saDraw || text_busy())
+        return;
+
+    saDraw = false;
+
+    // Draw bars & peaks
+    for(int i = 0; i < DISPLAYBANDS; i++) {
+        sid.drawBarWithHeight(i, oldHeight[i]);
+        if(doPeaks && peaks[i] > oldHeight[i] - 1) {
+            // Falling peaks are shown dimmer (dither mode only)
+            sid.drawDotLevel(i, peaks[i], (peakTimer[i] == PEAK_FALL) ? 85 : 170);
+        }
+    }
+    
+    sid.requestShow();
 }
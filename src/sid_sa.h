@@ -43,5 +43,6 @@ void sa_deactivate();
 int sa_setAmpFact(int newAmpFact);
 
 void sa_loop();
+void sa_frame(unsigned long now, unsigned long delta);
 
 #endif
@@ -0,0 +1,248 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Scheduler: Cooperative timed tasks
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+
+#include "sid_sched.h"
+#include "sid_frame.h"
+
+/*
+ * Long-running sequences (startup animation, timed feedback etc)
+ * are split into steps and run as tasks here, instead of blocking
+ * the main loop with delays. A task is a function that is called 
+ * with an incrementing step number, and returns the time until 
+ * its next step. Due tasks are run from sched_loop(), which is 
+ * called once per main loop iteration.
+ * 
+ * Tickless loop: At the end of each loop iteration, sched_sleep() 
+ * puts the loop task to sleep until the next deadline (next frame 
+ * clock tick, next due task), but not longer than SCHED_MAX_SLEEP
+ * ms, since network traffic (BTTFN, MQTT, web) needs polling. IR 
+ * reception and the TT button wake the loop up early through 
+ * sched_wakeupFromISR(). While audio is processed (SA), the loop 
+ * is paced by i2s and sched_stayAwake() prevents sleeping.
+ * 
+ * Also measures the time the loop was busy per iteration (latency)
+ * and the share of time spent sleeping; both are logged in debug 
+ * mode.
+ */
+
+typedef struct {
+    schedTask     task;
+    int           step;
+    unsigned long due;
+} schedEntry;
+
+static schedEntry    tasks[SCHED_MAX_TASKS];
+static int           numTasks = 0;
+
+static TaskHandle_t  loopTask = NULL;
+static bool          stayAwake = false;
+
+static unsigned long wakeUs = 0;
+static unsigned long maxLatency = 0;
+static unsigned long periodStart = 0;
+static unsigned long sleepUs = 0;
+static uint8_t       idlePercent = 0;
+
+#ifdef SID_DBG
+static unsigned long latDbgMax = 0;
+static int           dbgPeriods = 0;
+#endif
+
+void sched_setup()
+{
+    // Called from setup(), same task as loop()
+    loopTask = xTaskGetCurrentTaskHandle();
+    
+    periodStart = millis();
+    wakeUs = micros();
+}
+
+// Add task; first step is run after delay ms. If the 
+// task is already scheduled, it is restarted.
+bool sched_add(schedTask task, unsigned long delay)
+{
+    int i;
+    
+    for(i = 0; i < numTasks; i++) {
+        if(tasks[i].task == task)
+            break;
+    }
+
+    if(i == numTasks) {
+        if(numTasks >= SCHED_MAX_TASKS) {
+            #ifdef SID_DBG
+            Serial.println("sched_add: Too many tasks");
+            #endif
+            return false;
+        }
+        numTasks++;
+    }
+
+    tasks[i].task = task;
+    tasks[i].step = 0;
+    tasks[i].due = millis() + delay;
+
+    return true;
+}
+
+void sched_cancel(schedTask task)
+{
+    for(int i = 0; i < numTasks; i++) {
+        if(tasks[i].task == task) {
+            numTasks--;
+            for(int j = i; j < numTasks; j++) {
+                tasks[j] = tasks[j + 1];
+            }
+            return;
+        }
+    }
+}
+
+bool sched_running(schedTask task)
+{
+    for(int i = 0; i < numTasks; i++) {
+        if(tasks[i].task == task)
+            return true;
+    }
+
+    return false;
+}
+
+void sched_loop()
+{
+    unsigned long now = millis();
+    long next;
+
+    for(int i = 0; i < numTasks; i++) {
+        if((long)(now - tasks[i].due) < 0)
+            continue;
+        schedTask task = tasks[i].task;
+        next = task(tasks[i].step++);
+        // Task might have cancelled/added tasks; find it again
+        if(i >= numTasks || tasks[i].task != task) {
+            break;
+        }
+        if(next == SCHED_DONE) {
+            sched_cancel(task);
+            i--;
+        } else {
+            tasks[i].due = now + next;
+        }
+    }
+}
+
+// Skip sleeping in this loop iteration
+void sched_stayAwake()
+{
+    stayAwake = true;
+}
+
+void sched_wakeup()
+{
+    if(loopTask) {
+        xTaskNotifyGive(loopTask);
+    }
+}
+
+void IRAM_ATTR sched_wakeupFromISR()
+{
+    BaseType_t woken = pdFALSE;
+    
+    if(loopTask) {
+        vTaskNotifyGiveFromISR(loopTask, &woken);
+        if(woken) portYIELD_FROM_ISR();
+    }
+}
+
+// Sleep until next deadline; called at end of loop()
+void sched_sleep()
+{
+    unsigned long nowu = micros();
+    unsigned long now = millis();
+    unsigned long busy = (nowu - wakeUs) / 1000;
+    long wait = SCHED_MAX_SLEEP, d;
+
+    if(busy > maxLatency) maxLatency = busy;
+    #ifdef SID_DBG
+    if(busy > latDbgMax) latDbgMax = busy;
+    #endif
+
+    if(!stayAwake) {
+        for(int i = 0; i < numTasks; i++) {
+            d = (long)(tasks[i].due - now);
+            if(d < wait) wait = d;
+        }
+        d = frame_untilNext() / 1000;
+        if(d < wait) wait = d;
+    
+        if(wait > 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+        }
+    }
+    stayAwake = false;
+
+    wakeUs = micros();
+    sleepUs += wakeUs - nowu;
+
+    // Evaluate duty cycle once per second
+    now = millis();
+    if(now - periodStart >= 1000) {
+        idlePercent = sleepUs / ((now - periodStart) * 10);
+        if(idlePercent > 100) idlePercent = 100;
+        sleepUs = 0;
+        periodStart = now;
+        #ifdef SID_DBG
+        if(++dbgPeriods >= 60) {
+            Serial.printf("Scheduler: %d%% idle, max loop latency %lums (%lums since boot)\n", 
+                idlePercent, latDbgMax, maxLatency);
+            dbgPeriods = 0;
+            latDbgMax = 0;
+        }
+        #endif
+    }
+}
+
+// Maximum time the loop was busy in one iteration since boot (ms)
+unsigned long sched_getMaxLatency()
+{
+    return maxLatency;
+}
+
+// Share of time spent sleeping in the last second
+uint8_t sched_getIdlePercent()
+{
+    return idlePercent;
+}
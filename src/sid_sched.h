@@ -0,0 +1,62 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Scheduler: Cooperative timed tasks
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SID_SCHED_H
+#define _SID_SCHED_H
+
+#define SCHED_MAX_TASKS  8    // Max number of scheduled tasks
+
+#define SCHED_DONE      -1    // Returned by task when finished
+
+#define SCHED_MAX_SLEEP  10    // Max sleep time in ms (network polling)
+
+// Task: Called with its step number (0, 1, 2...); returns
+// ms until next step, or SCHED_DONE
+typedef long (*schedTask)(int step);
+
+void sched_setup();
+
+bool sched_add(schedTask task, unsigned long delay = 0);
+void sched_cancel(schedTask task);
+bool sched_running(schedTask task);
+
+void sched_loop();
+void sched_sleep();
+void sched_stayAwake();
+
+void sched_wakeup();
+void sched_wakeupFromISR();
+
+unsigned long sched_getMaxLatency();
+uint8_t       sched_getIdlePercent();
+
+#endif
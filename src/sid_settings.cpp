@@ -534,6 +534,54 @@ static bool openCfgFileRead(const char *fn, File& f, bool SDonly = false)
     return haveConfigFile;
 }
 
+/*
+ * Open a data file (eg. animation) for reading:
+ * From SD if present there, otherwise from flash FS
+ */
+bool openDataFileRead(const char *fn, File& f)
+{
+    bool haveFile = false;
+
+    if(haveSD && SD.exists(fn)) {
+        haveFile = (f = SD.open(fn, "r"));
+    }
+    if(!haveFile && haveFS && SPIFFS.exists(fn)) {
+        haveFile = (f = SPIFFS.open(fn, "r"));
+    }
+
+    return haveFile;
+}
+
+// Open a data file for writing; SD only
+bool openDataFileWrite(const char *fn, File& f)
+{
+    if(!haveSD)
+        return false;
+
+    return (f = SD.open(fn, FILE_WRITE));
+}
+
+// Replace data file "to" by "from"; SD only
+bool renameDataFile(const char *from, const char *to)
+{
+    if(!haveSD)
+        return false;
+
+    if(SD.exists(to)) {
+        SD.remove(to);
+    }
+
+    return SD.rename(from, to);
+}
+
+// Delete data file; SD only
+void removeDataFile(const char *fn)
+{
+    if(haveSD && SD.exists(fn)) {
+        SD.remove(fn);
+    }
+}
+
 /*
  *  Load/save the Brightness
  */
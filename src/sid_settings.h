@@ -33,6 +33,8 @@
 #ifndef _SID_SETTINGS_H
 #define _SID_SETTINGS_H
 
+#include <FS.h>
+
 extern bool haveSD;
 extern bool FlashROMode;
 
@@ -136,4 +138,9 @@ void deleteIpSettings();
 
 void formatFlashFS();
 
+bool openDataFileRead(const char *fn, File& f);
+bool openDataFileWrite(const char *fn, File& f);
+bool renameDataFile(const char *from, const char *to);
+void removeDataFile(const char *fn);
+
 #endif
@@ -36,6 +36,8 @@
 
 #include "sid_siddly.h"
 #include "sid_main.h" 
+#include "sid_text.h"
+#include "sid_rand.h"
 
 #define WIDTH  10
 #define HEIGHT 19
@@ -45,30 +47,47 @@
 
 bool siActive = false;
 
-static uint8_t board[HEIGHT][WIDTH] = { { 0 } };
+/*
+ * The board is kept as one bit mask per row. Bits 3-12 are the 
+ * board's columns 0-9; the bits left and right of it are always set,
+ * acting as walls. Pieces are pre-rotated into row masks (bit n = 
+ * column n of the piece's box), so that a collision test is one 
+ * shift and AND per piece row.
+ */
+#define BSHIFT   3
+#define BWALLS   ((uint16_t)~(((1 << WIDTH) - 1) << BSHIFT))
+#define BFULL    0xffff
+
+static uint16_t board[HEIGHT];
 
 #define NUM_PIECES 7
-static uint8_t p1[3][3] = { {0,0,1}, {1,1,1}, {0,0,0} };
-static uint8_t p2[3][3] = { {1,0,0}, {1,1,1}, {0,0,0} };
-static uint8_t p3[3][3] = { {0,1,1}, {1,1,0}, {0,0,0} };
-static uint8_t p4[3][3] = { {1,1,0}, {0,1,1}, {0,0,0} };
-static uint8_t p5[3][3] = { {0,1,0}, {1,1,1}, {0,0,0} };
-static uint8_t p6[2][2] = { {1,1}, {1,1} };
-static uint8_t p7[4][4] = { {0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0} };
-
-static uint8_t *pd[NUM_PIECES] = {
-    (uint8_t *)p1, (uint8_t *)p2, (uint8_t *)p3, (uint8_t *)p4, (uint8_t *)p5, (uint8_t *)p6, (uint8_t *)p7
+static const uint8_t p1[3][3] = { {0,0,1}, {1,1,1}, {0,0,0} };
+static const uint8_t p2[3][3] = { {1,0,0}, {1,1,1}, {0,0,0} };
+static const uint8_t p3[3][3] = { {0,1,1}, {1,1,0}, {0,0,0} };
+static const uint8_t p4[3][3] = { {1,1,0}, {0,1,1}, {0,0,0} };
+static const uint8_t p5[3][3] = { {0,1,0}, {1,1,1}, {0,0,0} };
+static const uint8_t p6[2][2] = { {1,1}, {1,1} };
+static const uint8_t p7[4][4] = { {0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0} };
+
+static const uint8_t *pd[NUM_PIECES] = {
+    (const uint8_t *)p1, (const uint8_t *)p2, (const uint8_t *)p3, (const uint8_t *)p4, 
+    (const uint8_t *)p5, (const uint8_t *)p6, (const uint8_t *)p7
 };
 
-static uint8_t ps[NUM_PIECES] = { 3, 3, 3, 3, 3, 2, 4 };
+static const uint8_t ps[NUM_PIECES] = { 3, 3, 3, 3, 3, 2, 4 };
+
+// Row masks of all pieces in all rotations (rotation n = n times left)
+static uint16_t pieceRows[NUM_PIECES][4][4];
+static uint8_t  pieceRots[NUM_PIECES];  // number of distinct rotations
+static bool     havePieceRows = false;
 
 static unsigned long ldelays[NUM_LEVELS] = {
     1000, 900, 800, 700, 600, 500, 400, 300, 200
 };
 
 static uint8_t cp  = 0;                 // current piece index
-static uint8_t cps = 0;                 // current piece size
-static uint8_t cpd[4][4] = { { 0 } };   // current piece data (copy of pX above)
+static uint8_t np  = 0;                 // next piece index
+static uint8_t cpr = 0;                 // current piece rotation
 static int     cpx = 0;                 // current x position
 static int     cpy = 0;                 // current y position
 
@@ -84,66 +103,112 @@ static bool           pauseShown = false;
 static int            level = 0;        // current level (speed)
 static int            pcnt = 0;         // piece count in level
 
-static void clearBoard()
+/*
+ * Demo mode: The computer plays. When a piece appears, all rotations
+ * and columns for it - and, for each of those, all placements of the 
+ * next piece - are tried out on copies of the board and rated by 
+ * aggregate height, complete lines, holes and bumpiness (weights 
+ * scaled from Yiyuan Lee's tuned Tetris player). The board copies
+ * live on the stack, and the rating is done with row masks, so the
+ * search takes a few milliseconds, far less than one tick at the 
+ * highest level.
+ */
+#define AI_W_HEIGHT  -51
+#define AI_W_LINES    76
+#define AI_W_HOLES   -36
+#define AI_W_BUMPS   -18
+#define AI_W_TOPOUT  -100000
+#define AI_STEP      150                // ms between demo player's moves
+
+static bool           siDemo = false;
+static int            aiRot = 0;        // target rotation
+static int            aiX = 0;          // target x position
+static unsigned long  aiNow = 0;
+static uint32_t       aiEvals = 0;      // placements rated (stats)
+
+static void buildPieceRows()
 {
-    memset(board, 0, sizeof(board));
-}
+    for(int p = 0; p < NUM_PIECES; p++) {
+        uint8_t cps = ps[p];
+        uint8_t cpd[4][4] = { { 0 } };
+        
+        for(int y = 0; y < cps; y++) {
+            for(int x = 0; x < cps; x++) {
+                cpd[y][x] = pd[p][(y * cps) + x];
+            }
+        }
+        
+        pieceRots[p] = 4;
+        for(int r = 0; r < 4; r++) {
+            uint8_t cpdb[4][4] = { { 0 } };
+            for(int y = 0; y < 4; y++) {
+                pieceRows[p][r][y] = 0;
+                for(int x = 0; x < cps; x++) {
+                    if(cpd[y][x]) pieceRows[p][r][y] |= (1 << x);
+                }
+            }
+            if(r && pieceRots[p] == 4 &&
+               !memcmp(pieceRows[p][r], pieceRows[p][0], sizeof(pieceRows[p][0]))) {
+                pieceRots[p] = r;
+            }
+            // Rotate left for next
+            for(int y = 0; y < cps; y++) {
+                for(int x = 0; x < cps; x++) {
+                    cpdb[cps - 1 - x][y] = cpd[y][x];
+                }
+            }
+            memcpy(cpd, cpdb, sizeof(cpd));
+        }
+    }
 
-static void setBoardAt(int x, int y)
-{
-    if(y < 0 || y > HEIGHT - 1) return;
-    if(x < 0 || x > WIDTH - 1)  return;
-    
-    board[y][x] = 1;
+    havePieceRows = true;
 }
 
-static int boardAt(int x, int y)
+static void clearBoard()
 {
-    if(y < 0 || y > HEIGHT - 1) return 0;
-    if(x < 0 || x > WIDTH - 1)  return 0;
-    
-    return board[y][x];
+    for(int y = 0; y < HEIGHT; y++) {
+        board[y] = BWALLS;
+    }
 }
 
-static bool lineIsFull(int y)
+// Check if piece p in rotation r fits at x, y on board b. Rows 
+// above the board are free (but for the walls), rows below are not.
+static bool fitsOn(const uint16_t *b, int p, int r, int x, int y)
 {
-    for(int x = 0; x < WIDTH; x++) {
-        if(!board[y][x])
-            return false;
+    const uint16_t *rows = pieceRows[p][r];
+    
+    for(int i = 0; i < 4; i++) {
+        uint16_t m;
+        if(!rows[i]) continue;
+        if(y + i >= HEIGHT) return false;
+        m = rows[i] << (x + BSHIFT);
+        if(m & (y + i < 0 ? BWALLS : b[y + i])) return false;
     }
     return true;
 }
 
-static void copyLine(int sy, int dy)
+static bool fits(int p, int r, int x, int y)
 {
-    for(int x = 0; x < WIDTH; x++) {
-          board[dy][x] = board[sy][x];
-    }
+    return fitsOn(board, p, r, x, y);
 }
 
-static void clearLine(int y)
+static void putPiece()
 {
-    for(int x = 0; x < WIDTH; x++) {
-          board[y][x] = 0;
-    }
-}
-
-static void removeLine(int yy)
-{       
-    if(yy > 0) {
-        for(int y = yy; y > 0; y--) {
-            copyLine(y - 1, y);
+    const uint16_t *rows = pieceRows[cp][cpr];
+    
+    for(int i = 0; i < 4; i++) {
+        if(rows[i] && cpy + i >= 0 && cpy + i < HEIGHT) {
+            board[cpy + i] |= rows[i] << (cpx + BSHIFT);
         }
     }
-
-    clearLine(0);
 }
 
 static void removeFullLines()
 {
     for(int y = HEIGHT - 1; y >= 0; y--) {
-        if(lineIsFull(y)) {
-            removeLine(y);
+        if(board[y] == BFULL) {
+            memmove(&board[1], &board[0], y * sizeof(board[0]));
+            board[0] = BWALLS;
             y++;
         }
     }
@@ -151,65 +216,22 @@ static void removeFullLines()
 
 static bool canPlace()
 {
-    bool mat = false;
-    int l = 0;
-    
-    for(int y = cps - 1; y >= 0; y--) {
-        for(int x = 0; x < cps; x++) {
-            if(cpd[y][x]) {
-                mat = true;
-                if(boardAt(cpx + x, cpy))
-                    return false;
-            }
-        }
-        if(mat) l++;
-        if(cpy - l < 0)
-            break;
-    }
-    return true;
+    return fits(cp, cpr, cpx, cpy);
 }
 
 static bool canRotate()
 {
-    for(int y = 0; y < cps; y++) {
-        for(int x = 0; x < cps; x++) {
-            if(cpd[y][x]) {
-                int ny = cpy + cps - 1 - x;
-                int nx = cpx + y;
-                if((ny >= HEIGHT) ||
-                   (nx < 0 || nx >= WIDTH) ||
-                   (boardAt(nx, ny)))
-                    return false;
-            }
-        }
-    }
-    return true;
+    return fits(cp, (cpr + 1) & 3, cpx, cpy);
 }
 
 static void rotate()
 {
-    uint8_t cpdb[4][4] = { { 0 } };
-    
-    for(int y = 0; y < cps; y++) {
-        for(int x = 0; x < cps; x++) {
-            cpdb[cps - 1 - x][y] = cpd[y][x];
-        }
-    }
-    memcpy(cpd, cpdb, sizeof(cpd));
+    cpr = (cpr + 1) & 3;
 }
 
 static bool canMoveDown()
 {
-    for(int y = 0; y < cps; y++) {
-        for(int x = 0; x < cps; x++) {
-            if(cpd[y][x]) {
-                if((cpy + y + 1 >= HEIGHT) ||
-                   boardAt(cpx + x, cpy + y + 1))
-                    return false;
-            }
-        }
-    }
-    return true;
+    return fits(cp, cpr, cpx, cpy + 1);
 }
 
 static void moveDown()
@@ -219,16 +241,7 @@ static void moveDown()
 
 static bool canMoveLeft()
 {
-    for(int y = 0; y < cps; y++) {
-        for(int x = 0; x < cps; x++) {
-            if(cpd[y][x]) {
-                if((cpx + x - 1 < 0) ||
-                   boardAt(cpx + x - 1, cpy + y))
-                    return false;
-            }
-        }
-    }
-    return true;
+    return fits(cp, cpr, cpx - 1, cpy);
 }
 
 static void moveLeft()
@@ -238,16 +251,7 @@ static void moveLeft()
 
 static bool canMoveRight()
 {
-    for(int y = 0; y < cps; y++) {
-        for(int x = 0; x < cps; x++) {
-            if(cpd[y][x]) {
-                if((cpx + x + 1 >= WIDTH) ||
-                   boardAt(cpx + x + 1, cpy + y))
-                    return false;
-            }
-        }
-    }
-    return true;
+    return fits(cp, cpr, cpx + 1, cpy);
 }
 
 static void moveRight()
@@ -255,24 +259,126 @@ static void moveRight()
     cpx++;
 }
 
-static bool newPiece()
+/*
+ * Demo player
+ */
+
+// Put piece on board b and remove full lines. Returns the number 
+// of lines removed, or -1 if the piece sticks out at the top.
+static int placeOn(uint16_t *b, int p, int r, int x, int y)
 {
-    cp = esp_random() % NUM_PIECES;
-    cps = ps[cp];
-    cpx = (WIDTH - cps) / 2;
-    cpy = 0;
+    const uint16_t *rows = pieceRows[p][r];
+    int lines = 0;
+    
+    for(int i = 0; i < 4; i++) {
+        if(!rows[i]) continue;
+        if(y + i < 0) return -1;
+        b[y + i] |= rows[i] << (x + BSHIFT);
+    }
+
+    for(int yy = min(y + 3, HEIGHT - 1); yy >= 0; yy--) {
+        if(b[yy] == BFULL) {
+            memmove(&b[1], &b[0], yy * sizeof(b[0]));
+            b[0] = BWALLS;
+            yy++;
+            lines++;
+        }
+    }
+
+    return lines;
+}
 
-    uint8_t *npd = pd[cp];
-    for(int y = 0; y < cps; y++) {
-        for(int x = 0; x < cps; x++) {
-            cpd[y][x] = *(npd + (y * cps) + x);
+// Rate board b. Top to bottom, "seen" collects all columns that 
+// have a block in the current row or above; a free cell in a seen 
+// column is a hole, and the number of seen columns summed over all 
+// rows is the aggregate height.
+static int32_t rateBoard(const uint16_t *b, int lines)
+{
+    uint16_t seen = 0;
+    int height = 0, holes = 0, bumps = 0;
+    int colh[WIDTH];
+
+    for(int y = 0; y < HEIGHT; y++) {
+        uint16_t row = b[y] & ~BWALLS;
+        uint16_t nw = row & ~seen;
+        holes += __builtin_popcount(seen & ~row);
+        while(nw) {
+            int c = __builtin_ctz(nw);
+            colh[c - BSHIFT] = HEIGHT - y;
+            nw &= nw - 1;
         }
+        seen |= row;
+        height += __builtin_popcount(seen);
     }
     
+    for(int c = 0; c < WIDTH; c++) {
+        if(!(seen & (1 << (c + BSHIFT)))) colh[c] = 0;
+    }
+    for(int c = 0; c < WIDTH - 1; c++) {
+        bumps += abs(colh[c] - colh[c + 1]);
+    }
+
+    aiEvals++;
+
+    return AI_W_HEIGHT * height + AI_W_LINES * lines + 
+           AI_W_HOLES * holes + AI_W_BUMPS * bumps;
+}
+
+// Best rating of all placements of piece p (spawned at row y) on b
+static int32_t bestPlacement(const uint16_t *b, int p, int y, int lines, int *br, int *bx)
+{
+    uint16_t nb[HEIGHT];
+    int32_t best = INT32_MIN;
+    
+    for(int r = 0; r < pieceRots[p]; r++) {
+        for(int x = -3; x < WIDTH; x++) {
+            int32_t rating;
+            int yy = y, l;
+            if(!fitsOn(b, p, r, x, yy)) continue;
+            while(fitsOn(b, p, r, x, yy + 1)) yy++;
+            memcpy(nb, b, sizeof(nb));
+            if((l = placeOn(nb, p, r, x, yy)) < 0) continue;
+            if(br) {
+                // First piece: Rate by best placement of next piece
+                rating = bestPlacement(nb, np, 0, lines + l, NULL, NULL);
+                if(rating == INT32_MIN) {
+                    rating = rateBoard(nb, lines + l) + AI_W_TOPOUT;
+                }
+            } else {
+                rating = rateBoard(nb, lines + l);
+            }
+            if(rating > best) {
+                best = rating;
+                if(br) { *br = r; *bx = x; }
+            }
+        }
+    }
+
+    return best;
+}
+
+static void aiSearch()
+{
+    aiRot = cpr;
+    aiX = cpx;
+    bestPlacement(board, cp, cpy, 0, &aiRot, &aiX);
+}
+
+static bool newPiece()
+{
+    cp = np;
+    np = rand_below(NUM_PIECES);
+    cpr = 0;
+    cpx = (WIDTH - ps[cp]) / 2;
+    cpy = 0;
+
     if(canPlace()) {
-        cp_now = millis();
+        cp_now = aiNow = millis();
         pcnt++;
         havePiece = true;
+        if(siDemo) {
+            aiSearch();
+        }
     } else {
         gameOver = true;
         havePiece = false;
@@ -284,26 +390,48 @@ static bool newPiece()
 
 static void updateDisplay()
 {
-    uint8_t myField[WIDTH * (HEIGHT + 1)];
-
-    memset((void *)myField, 0, WIDTH);
+    // Row 0: Pieces left in level; rows 1-19: board
+    uint16_t myRows[HEIGHT + 1];
+    int n = min(10, ((PIECES_PER_LEVEL - pcnt) * 10 / PIECES_PER_LEVEL) + 1);
 
-    for(int i = 0; i < min(10, ((PIECES_PER_LEVEL - pcnt) * 10 / PIECES_PER_LEVEL) + 1); i++) {
-        myField[i] = 1;
-    }
+    myRows[0] = (1 << n) - 1;
     
-    memcpy((void *)(myField + WIDTH), (void *)board, WIDTH * HEIGHT);
+    for(int y = 0; y < HEIGHT; y++) {
+        myRows[y + 1] = board[y];
+    }
 
     if(havePiece) {
-        for(int y = 0; y < cps; y++) {
-            for(int x = 0; x < cps; x++) {
-                if(cpd[y][x]) {
-                    myField[((cpy + y + 1) * WIDTH) + cpx + x] = 1;
-                }
+        const uint16_t *rows = pieceRows[cp][cpr];
+        for(int i = 0; i < 4; i++) {
+            if(rows[i] && cpy + i >= 0 && cpy + i < HEIGHT) {
+                myRows[cpy + i + 1] |= rows[i] << (cpx + BSHIFT);
             }
         }
     }
-    sid.drawFieldAndShow((uint8_t *)myField);
+
+    for(int y = 1; y <= HEIGHT; y++) {
+        myRows[y] = (myRows[y] & ~BWALLS) >> BSHIFT;
+    }
+    
+    sid.drawFieldRows(myRows);
+    sid.requestShow();
+}
+
+// Move one step towards target position; once there, drop
+static void aiMove()
+{
+    if(cpr != aiRot && canRotate()) {
+        rotate();
+    } else if(cpx < aiX && canMoveRight()) {
+        moveRight();
+    } else if(cpx > aiX && canMoveLeft()) {
+        moveLeft();
+    } else if(canMoveDown()) {
+        moveDown();
+    } else {
+        return;
+    }
+    updateDisplay();
 }
 
 static void resetGame()
@@ -312,27 +440,43 @@ static void resetGame()
     level = 0;
     gameOver = gameOverShown = false;
     pauseGame = pauseShown = false;
+    np = rand_below(NUM_PIECES);
     
     clearBoard();
 }
 
-void si_init()          // start game
+// Title shown: Start game after a second
+static void titleDone()
 {
+    siStartup = millis();
+}
+
+void si_init(bool demo)  // start game
+{
+    if(!havePieceRows) {
+        buildPieceRows();
+    }
+    
+    siDemo = demo;
+    
     resetGame();
 
-    showWordSequence("SIDDLY", 2);
+    showWordSequence(demo ? "SIDDLY DEMO" : "SIDDLY", 2, titleDone);
 
     siStartup = millis();
     siActive = true;
 }
 
-void si_loop()
+void si_frame(unsigned long now, unsigned long delta)
 {
-    unsigned long now = millis();
     
     if(!siActive)
         return;
 
+    // Wait for text engine (title, level, game over)
+    if(text_busy())
+        return;
+
     if(gameOver) {
         if(!gameOverShown) {
             showWordSequence("GAME OVER ", 1);
@@ -357,11 +501,17 @@ void si_loop()
 
     if(pauseGame) {
         if(!pauseShown) {
-            sid.drawLetterAndShow('P');
+            sid.drawLetter('P');
+            sid.requestShow();
             pauseShown = true;
         }
         return;
     }
+
+    if(siDemo && havePiece && !removeCycle && now - aiNow >= AI_STEP) {
+        aiMove();
+        aiNow = now;
+    }
     
     if(now - cp_now < ldelays[level])
         return;
@@ -393,13 +543,7 @@ void si_loop()
         cp_now = now;
     } else {
         // Put piece into board
-        for(int y = 0; y < cps; y++) {
-            for(int x = 0; x < cps; x++) {
-                if(cpd[y][x]) {
-                    setBoardAt(cpx + x, cpy + y);
-                }
-            }
-        }
+        putPiece();
         removeCycle = true;
         cp_now = now;
     }
@@ -420,6 +564,9 @@ void si_newGame()
     if(!siActive || siStartup)
         return;
 
+    // Ends demo mode; user takes over
+    siDemo = false;
+    
     resetGame();
     
     newPiece();
@@ -428,7 +575,7 @@ void si_newGame()
 
 void si_pause()
 {
-    if(!siActive || gameOver || siStartup)
+    if(!siActive || siDemo || gameOver || siStartup)
         return;
 
     pauseGame = !pauseGame;
@@ -437,7 +584,7 @@ void si_pause()
 
 void si_moveRight()     // move right
 {
-    if(!siActive || gameOver || siStartup || !havePiece || pauseGame)
+    if(!siActive || siDemo || gameOver || siStartup || !havePiece || pauseGame)
         return;
 
     if(canMoveRight()) {
@@ -448,7 +595,7 @@ void si_moveRight()     // move right
 
 void si_moveLeft()      // move left
 {
-    if(!siActive || gameOver || siStartup || !havePiece || pauseGame)
+    if(!siActive || siDemo || gameOver || siStartup || !havePiece || pauseGame)
         return;
 
     if(canMoveLeft()) {
@@ -459,7 +606,7 @@ void si_moveLeft()      // move left
 
 void si_moveDown()      // move down
 {
-    if(!siActive || gameOver || siStartup || !havePiece || pauseGame)
+    if(!siActive || siDemo || gameOver || siStartup || !havePiece || pauseGame)
         return;
 
     if(canMoveDown()) {
@@ -472,7 +619,7 @@ void si_moveDown()      // move down
 void si_fallDown()      // fall down
 {
     
-    if(!siActive || gameOver || siStartup || !havePiece || pauseGame)
+    if(!siActive || siDemo || gameOver || siStartup || !havePiece || pauseGame)
         return;
 
     while(canMoveDown()) {
@@ -483,7 +630,7 @@ void si_fallDown()      // fall down
 
 void si_rotate()        // rotate (left)
 {
-    if(!siActive || gameOver || siStartup || !havePiece || pauseGame)
+    if(!siActive || siDemo || gameOver || siStartup || !havePiece || pauseGame)
         return;
 
     if(canRotate()) {
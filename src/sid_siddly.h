@@ -35,8 +35,8 @@
 
 extern bool siActive;    // read only!!!
 
-void si_init();          // start game
-void si_loop();          // game loop
+void si_init(bool demo = false);  // start game (demo: computer plays)
+void si_frame(unsigned long now, unsigned long delta);  // game loop (frame callback)
 void si_end();           // end game (quit)
 void si_newGame();       // restart game (when active)
 void si_pause();         // pause game (toggle)
@@ -36,6 +36,8 @@
 
 #include "sid_snake.h"
 #include "sid_main.h" 
+#include "sid_text.h"
+#include "sid_rand.h"
 
 #define WIDTH  10
 #define HEIGHT 20
@@ -86,7 +88,8 @@ static void updateDisplay()
         myField[(apy * WIDTH) + apx] = 1;
     }
     
-    sid.drawFieldAndShow((uint8_t *)myField);
+    sid.drawField((uint8_t *)myField);
+    sid.requestShow();
 }
 
 static void shiftSnake()
@@ -129,26 +132,35 @@ static void resetGame()
     pauseGame = pauseShown = false;
 }
 
+// Title shown: Start game after a second
+static void titleDone()
+{
+    snStartup = millis();
+}
+
 void sn_init()
 {
     resetGame();
     level = 0;
     
-    showWordSequence("SNAKE", 2);
+    showWordSequence("SNAKE", 2, titleDone);
 
     snStartup = millis();
     snActive = true;
 }
 
-void sn_loop()
+void sn_frame(unsigned long now, unsigned long delta)
 {
-    unsigned long now = millis();
     bool skipCheck = false;
     bool newApple = false;
     
     if(!snActive)
         return;
 
+    // Wait for text engine (title, level, game over)
+    if(text_busy())
+        return;
+
     if(gameOver) {
         if(!gameOverShown) {
             showWordSequence("GAME OVER ", 1);
@@ -174,7 +186,8 @@ void sn_loop()
 
     if(pauseGame) {
         if(!pauseShown) {
-            sid.drawLetterAndShow('P');
+            sid.drawLetter('P');
+            sid.requestShow();
             pauseShown = true;
         }
         return;
@@ -223,8 +236,8 @@ void sn_loop()
     // Make new apply
     if(newApple) {
         do {
-          apx = esp_random() % WIDTH;
-          apy = esp_random() % HEIGHT;
+          apx = rand_below(WIDTH);
+          apy = rand_below(HEIGHT);
         } while(appleHitsSnake());
     }
 
@@ -36,7 +36,7 @@
 extern bool snActive;    // read only!!!
 
 void sn_init();          // start game
-void sn_loop();          // game loop
+void sn_frame(unsigned long now, unsigned long delta);  // game loop (frame callback)
 void sn_end();           // end game (quit)
 void sn_newGame();       // restart game (when active)
 void sn_pause();         // pause game (toggle)
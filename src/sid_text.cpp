@@ -0,0 +1,265 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Text engine: Non-blocking word sequences and scrolling
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+
+#include "sid_text.h"
+#include "sid_main.h"
+
+/*
+ * Text jobs are queued and run by text_frame(), a frame clock
+ * callback, without blocking the main loop. While a job is active,
+ * the text engine owns the display: Idle patterns, SA and games 
+ * check text_busy() and don't draw.
+ * 
+ * Word sequence: Each letter is shown for a while, then faded out
+ *                by lowering the display brightness.
+ * Fade out:      Fade out whatever is currently displayed.
+ * Scroll:        Text is scrolled by pixel, horizontally or 
+ *                vertically.
+ * 
+ * At the end of each job, the display is cleared, brightness is
+ * restored, and the job's callback (if any) is called.
+ */
+
+#define TJ_WORDSEQ  0
+#define TJ_FADEOUT  1
+#define TJ_SCROLL   2
+
+#define TS_START    0
+#define TS_SHOW     1
+#define TS_HOLD     2
+#define TS_FADE     3
+#define TS_GAP      4
+#define TS_SCROLL   5
+
+#define TEXT_FADE_STEP  10    // ms per brightness level when fading out
+#define TEXT_GAP        50    // ms between letters
+#define TEXT_CHAR_DIST  11    // pixels from letter to letter when scrolling
+
+typedef struct {
+    uint8_t      type;
+    uint8_t      speed;
+    uint8_t      dir;
+    char         text[TEXT_MAX_LEN + 1];
+    textCallback cb;
+} textJob;
+
+static const uint16_t speedDelay[6]  = { 100, 200, 300, 400, 500, 1000 };   // ms per letter
+static const uint8_t  scrollDelay[6] = {  15,  25,  35,  50,  70,  100 };   // ms per pixel
+
+static textJob       jobs[TEXT_MAX_JOBS];
+static int           jobHead = 0;
+static int           jobCnt = 0;
+
+static uint8_t       state = TS_START;
+static int           charIdx = 0;
+static int           scrollEnd = 0;
+static int           textLen = 0;
+static unsigned long stateNow = 0;
+
+static bool addJob(uint8_t type, const char *text, int speed, uint8_t dir, textCallback cb)
+{
+    textJob *j;
+    
+    if(jobCnt >= TEXT_MAX_JOBS) {
+        #ifdef SID_DBG
+        Serial.println("Text: Queue full");
+        #endif
+        return false;
+    }
+
+    if(speed < 0) speed = 0;
+    if(speed > 5) speed = 5;
+
+    j = &jobs[(jobHead + jobCnt) % TEXT_MAX_JOBS];
+    j->type = type;
+    j->speed = speed;
+    j->dir = dir;
+    j->text[0] = 0;
+    if(text) {
+        strncpy(j->text, text, TEXT_MAX_LEN);
+        j->text[TEXT_MAX_LEN] = 0;
+    }
+    j->cb = cb;
+
+    jobCnt++;
+
+    return true;
+}
+
+bool showWordSequence(const char *text, int speed, textCallback cb)
+{
+    return addJob(TJ_WORDSEQ, text, speed, 0, cb);
+}
+
+bool scrollText(const char *text, int dir, int speed, textCallback cb)
+{
+    return addJob(TJ_SCROLL, text, speed, dir, cb);
+}
+
+bool fadeOutChar(textCallback cb)
+{
+    return addJob(TJ_FADEOUT, NULL, 0, 0, cb);
+}
+
+bool text_busy()
+{
+    return (jobCnt > 0);
+}
+
+static void endJob(bool runCB)
+{
+    textCallback cb = jobs[jobHead].cb;
+
+    sid.clearDisplayDirect();
+    sid.setBrightness(255);
+
+    jobHead = (jobHead + 1) % TEXT_MAX_JOBS;
+    jobCnt--;
+    state = TS_START;
+
+    if(runCB && cb) {
+        cb();
+    }
+}
+
+// Abort current and all queued jobs; callbacks are not called
+void text_abort()
+{
+    if(!jobCnt)
+        return;
+
+    while(jobCnt) {
+        endJob(false);
+    }
+}
+
+static void startFade()
+{
+    sid.fadeOut((sid.getBrightness() + 1) * TEXT_FADE_STEP);
+    state = TS_FADE;
+}
+
+static void drawScroll(int pos, uint8_t dir)
+{
+    sid.clearBuf();
+    
+    for(int i = 0; i < textLen; i++) {
+        int p = i * TEXT_CHAR_DIST - pos;
+        if(dir == TEXT_SCROLL_V) {
+            sid.addLetter(jobs[jobHead].text[i], 0, 20 + p);
+        } else {
+            sid.addLetter(jobs[jobHead].text[i], 10 + p, 8);
+        }
+    }
+    
+    sid.requestShow();
+}
+
+void text_frame(unsigned long now, unsigned long delta)
+{
+    textJob *j;
+    int pos;
+    
+    if(!jobCnt)
+        return;
+
+    j = &jobs[jobHead];
+
+    switch(state) {
+    case TS_START:
+        charIdx = 0;
+        textLen = strlen(j->text);
+        switch(j->type) {
+        case TJ_FADEOUT:
+            // Fade out what is on the display; endJob() clears
+            // it and restores the brightness afterwards
+            startFade();
+            break;
+        case TJ_SCROLL:
+            sid.clearDisplayDirect();
+            sid.setBrightness(255);
+            scrollEnd = (textLen - 1) * TEXT_CHAR_DIST + ((j->dir == TEXT_SCROLL_V) ? 30 : 20);
+            stateNow = now;
+            state = TS_SCROLL;
+            break;
+        default:
+            sid.clearDisplayDirect();
+            state = textLen ? TS_SHOW : TS_GAP;
+            stateNow = now;
+        }
+        break;
+        
+    case TS_SHOW:
+        sid.drawLetter(j->text[charIdx], 0, 8);
+        sid.requestShow();
+        sid.setBrightness(255);
+        stateNow = now;
+        state = TS_HOLD;
+        break;
+
+    case TS_HOLD:
+        if(now - stateNow >= speedDelay[j->speed]) {
+            startFade();
+        }
+        break;
+
+    case TS_FADE:
+        if(!sid.isFading()) {
+            stateNow = now;
+            state = TS_GAP;
+        }
+        break;
+
+    case TS_GAP:
+        if(now - stateNow >= TEXT_GAP) {
+            if(j->type == TJ_WORDSEQ && ++charIdx < textLen) {
+                state = TS_SHOW;
+            } else {
+                endJob(true);
+            }
+        }
+        break;
+
+    case TS_SCROLL:
+        pos = (now - stateNow) / scrollDelay[j->speed];
+        if(pos > scrollEnd) {
+            endJob(true);
+        } else {
+            drawScroll(pos, j->dir);
+        }
+        break;
+    }
+}
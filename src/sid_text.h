@@ -0,0 +1,54 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Text engine: Non-blocking word sequences and scrolling
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SID_TEXT_H
+#define _SID_TEXT_H
+
+#define TEXT_MAX_JOBS  4     // Max number of queued text jobs
+#define TEXT_MAX_LEN  24     // Max text length per job
+
+#define TEXT_SCROLL_H  0     // Scroll right to left
+#define TEXT_SCROLL_V  1     // Scroll bottom to top
+
+// Called when a text job has finished (not when aborted)
+typedef void (*textCallback)();
+
+bool showWordSequence(const char *text, int speed = 3, textCallback cb = NULL);
+bool scrollText(const char *text, int dir = TEXT_SCROLL_H, int speed = 3, textCallback cb = NULL);
+bool fadeOutChar(textCallback cb = NULL);
+
+void text_abort();
+bool text_busy();
+
+void text_frame(unsigned long now, unsigned long delta);
+
+#endif
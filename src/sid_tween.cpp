@@ -0,0 +1,146 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Tween: Keyframe interpolation for bar animations
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#include <Arduino.h>
+
+#include "sid_tween.h"
+#include "sid_main.h"
+
+/*
+ * Idle patterns compute target bar heights (keyframes) at their own 
+ * pace (every few hundred ms). Instead of jumping to these heights, 
+ * tween_to() starts a transition from the currently shown heights, 
+ * and tween_frame() draws the intermediate frames at the frame 
+ * clock's rate. Integer only; easing as for brightness fades. 
+ * A new keyframe replaces a running transition, starting from 
+ * where the current one has got to. After tween_stop(), the next
+ * keyframe is shown without transition.
+ * 
+ * Heights are as for drawBarWithHeight().
+ */
+
+static bool          tweenActive = false;
+static bool          tweenValid = false;
+static bool          tweenDirty = false;
+static uint8_t       tweenFrom[SD_BARS];
+static uint8_t       tweenTo[SD_BARS];
+static uint8_t       tweenCur[SD_BARS];
+static unsigned long tweenStart = 0;
+static uint16_t      tweenDur = 0;
+static uint8_t       tweenEase = SD_EASE_LINEAR;
+
+// CPU time statistics
+static unsigned long tweenFrameUs = 0;    // Moving average, scaled by 16
+#ifdef SID_DBG
+static unsigned long tweenMaxUs = 0;
+static unsigned long tweenLastReport = 0;
+#endif
+
+void tween_to(const uint8_t *heights, uint16_t duration, uint8_t ease)
+{
+    if(!tweenValid) {
+        memcpy(tweenCur, heights, SD_BARS);
+        tweenValid = true;
+    }
+
+    memcpy(tweenFrom, tweenCur, SD_BARS);
+    memcpy(tweenTo, heights, SD_BARS);
+    
+    tweenStart = millis();
+    tweenDur = duration;
+    tweenEase = ease;
+    tweenActive = tweenDirty = true;
+}
+
+void tween_stop()
+{
+    tweenActive = tweenValid = false;
+}
+
+bool tween_isActive()
+{
+    return tweenActive;
+}
+
+/*
+ * Draw intermediate frame; returns true if any bar has
+ * changed (caller then needs to show the display)
+ */
+bool tween_frame(unsigned long now)
+{
+    unsigned long us;
+    int t, h;
+    bool changed = tweenDirty;
+
+    if(!tweenActive)
+        return false;
+
+    us = micros();
+
+    t = sidDisplay::ease(tweenEase, now - tweenStart, tweenDur);
+
+    for(int i = 0; i < SD_BARS; i++) {
+        h = tweenFrom[i] + ((((int)tweenTo[i] - (int)tweenFrom[i]) * t) >> 8);
+        if(h != tweenCur[i] || tweenDirty) {
+            tweenCur[i] = h;
+            sid.drawBarWithHeight(i, h);
+            changed = true;
+        }
+    }
+
+    tweenDirty = false;
+    if(t >= 256) {
+        tweenActive = false;
+    }
+
+    us = micros() - us;
+    tweenFrameUs += us - (tweenFrameUs >> 4);
+    
+    #ifdef SID_DBG
+    if(us > tweenMaxUs) tweenMaxUs = us;
+    if(now - tweenLastReport >= 60000) {
+        Serial.printf("Tween: %luus avg, %luus max per frame\n", tween_getFrameUs(), tweenMaxUs);
+        tweenLastReport = now;
+        tweenMaxUs = 0;
+    }
+    #endif
+
+    return changed;
+}
+
+// Average CPU time per frame in us
+unsigned long tween_getFrameUs()
+{
+    return tweenFrameUs >> 4;
+}
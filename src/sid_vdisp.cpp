@@ -0,0 +1,271 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Virtual display: Decodes HT16K33 traffic for debugging
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include "sid_global.h"
+
+#ifdef SID_VDISPLAY
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "siddisplay.h"
+#include "sid_vdisp.h"
+
+/*
+ * The virtual display sits between sidDisplay and Wire. Every 
+ * transaction is fed into a model of the HT16K33 chips (RAM,
+ * oscillator, display on/blink, dimming); after each RAM write, 
+ * the LED image is rebuilt from chip RAM through the wiring 
+ * table. Changed frames are counted, optionally dumped
+ * as ASCII art (SID_VDISPLAY_DUMP), and bus statistics as well as
+ * show() timing are printed every 10 seconds.
+ * 
+ * The data is passed on to the real chips unchanged, so this can 
+ * be used with or without the SID panel connected.
+ */
+
+#define VD_REPORT_INT 10000
+
+sidVWire vWire;
+
+static portMUX_TYPE vdMux = portMUX_INITIALIZER_UNLOCKED;
+
+void sidVWire::begin(const uint8_t *addresses)
+{
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        _address[j] = addresses[j];
+        _ptr[j] = _blink[j] = 0;
+        _osc[j] = _on[j] = false;
+        _dim[j] = 15;
+    }
+    memset(_ram, 0, sizeof(_ram));
+    memset(_img, 0, sizeof(_img));
+
+    _lastReport = millis();
+}
+
+void sidVWire::beginTransmission(uint8_t address)
+{
+    int core = xPortGetCoreID() & 1;
+    
+    _tAddr[core] = address;
+    _tLen[core] = 0;
+}
+
+size_t sidVWire::write(uint8_t val)
+{
+    int core = xPortGetCoreID() & 1;
+    
+    if(_tLen[core] >= VD_MAX_TRANS)
+        return 0;
+    _tBuf[core][_tLen[core]++] = val;
+    
+    return 1;
+}
+
+uint8_t sidVWire::endTransmission()
+{
+    int core = xPortGetCoreID() & 1;
+    int chip = -1;
+    bool newFrame = false;
+    uint32_t snap[SD_BARS];
+    uint8_t ret;
+    unsigned long now;
+
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        if(_tAddr[core] == _address[j]) {
+            chip = j;
+            break;
+        }
+    }
+
+    portENTER_CRITICAL(&vdMux);
+    if(chip >= 0 && decode(chip, _tBuf[core], _tLen[core])) {
+        newFrame = checkFrame(snap);
+    }
+    _trans++;
+    _bytes += _tLen[core] + 1;   // plus address byte
+    portEXIT_CRITICAL(&vdMux);
+
+    Wire.beginTransmission(_tAddr[core]);
+    for(int i = 0; i < _tLen[core]; i++) {
+        Wire.write(_tBuf[core][i]);
+    }
+    ret = Wire.endTransmission();
+
+    now = millis();
+
+    #ifdef SID_VDISPLAY_DUMP
+    if(newFrame && (now - _lastDump >= SID_VDISPLAY_DUMP)) {
+        dumpFrame(now, snap);
+        _lastDump = now;
+    }
+    #else
+    (void)newFrame;
+    #endif
+
+    if(now - _lastReport >= VD_REPORT_INT) {
+        report(now);
+    }
+
+    return ret;
+}
+
+// Called by sidDisplay::show() with the time it took
+void sidVWire::showTime(unsigned long us)
+{
+    portENTER_CRITICAL(&vdMux);
+    _shows++;
+    _showUs += us;
+    if(us > _showMax) _showMax = us;
+    portEXIT_CRITICAL(&vdMux);
+}
+
+// Copy decoded LED image (SD_BARS words, bit 0 = top row)
+void sidVWire::getImage(uint32_t *img)
+{
+    portENTER_CRITICAL(&vdMux);
+    memcpy(img, _img, sizeof(_img));
+    portEXIT_CRITICAL(&vdMux);
+}
+
+// Model the HT16K33 command set. Returns true if RAM was written.
+bool sidVWire::decode(int chip, const uint8_t *data, int len)
+{
+    uint8_t cmd;
+    
+    if(!len)
+        return false;
+
+    cmd = data[0];
+
+    switch(cmd & 0xf0) {
+    case 0x00:      // Display data address pointer, followed by data
+        _ptr[chip] = cmd & 0x0f;
+        for(int i = 1; i < len; i++) {
+            _ram[chip][_ptr[chip]] = data[i];
+            _ptr[chip] = (_ptr[chip] + 1) % (SD_CHIP_WORDS * 2);
+        }
+        return (len > 1);
+    case 0x20:      // System setup
+        _osc[chip] = !!(cmd & 0x01);
+        break;
+    case 0x80:      // Display setup
+        _on[chip] = !!(cmd & 0x01);
+        _blink[chip] = (cmd >> 1) & 0x03;
+        break;
+    case 0xe0:      // Dimming
+        _dim[chip] = cmd & 0x0f;
+        break;
+    }
+
+    return false;
+}
+
+// Rebuild LED image from chip RAM; returns true if it changed
+bool sidVWire::checkFrame(uint32_t *snap)
+{
+    uint16_t buf[SD_BUF_SIZE];
+    uint32_t img;
+    int changes = 0;
+
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        for(int i = 0; i < SD_CHIP_WORDS; i++) {
+            buf[j * SD_CHIP_WORDS + i] = _ram[j][i * 2] | (_ram[j][i * 2 + 1] << 8);
+        }
+    }
+
+    for(int x = 0; x < SD_BARS; x++) {
+        img = 0;
+        for(int y = 0; y < SD_ROWS; y++) {
+            if(sidDisplay::isLit(buf, x, y)) img |= (1 << y);
+        }
+        changes += __builtin_popcount(img ^ _img[x]);
+        _img[x] = snap[x] = img;
+    }
+
+    if(changes) {
+        _frames++;
+        _ledChanges += changes;
+        return true;
+    }
+    
+    return false;
+}
+
+void sidVWire::dumpFrame(unsigned long now, const uint32_t *snap)
+{
+    char line[SD_BARS + 4];
+
+    Serial.printf("VD %lu ms, frame %d, dim %d%s\n", now, _frames, _dim[0], _on[0] ? "" : ", off");
+    
+    line[0] = line[SD_BARS + 1] = '|';
+    line[SD_BARS + 2] = '\n';
+    line[SD_BARS + 3] = 0;
+    for(int y = 0; y < SD_ROWS; y++) {
+        for(int x = 0; x < SD_BARS; x++) {
+            line[x + 1] = (snap[x] & (1 << y)) ? '#' : '.';
+        }
+        Serial.print(line);
+    }
+}
+
+void sidVWire::report(unsigned long now)
+{
+    uint32_t trans, bytes, frames, ledChanges, shows;
+    unsigned long showUs, showMax, secs;
+
+    portENTER_CRITICAL(&vdMux);
+    if(now - _lastReport < VD_REPORT_INT) {
+        portEXIT_CRITICAL(&vdMux);
+        return;
+    }
+    secs = (now - _lastReport) / 1000;
+    _lastReport = now;
+    trans = _trans; bytes = _bytes; frames = _frames; 
+    ledChanges = _ledChanges; shows = _shows;
+    showUs = _showUs; showMax = _showMax;
+    _trans = _bytes = _frames = _ledChanges = _shows = 0;
+    _showUs = _showMax = 0;
+    portEXIT_CRITICAL(&vdMux);
+
+    Serial.printf("VD: %u trans, %lu bytes/s, %lu frames/s, %u LED changes/frame; show() %u x, avg %luus, max %luus\n",
+        trans, bytes / secs, frames / secs, 
+        frames ? ledChanges / frames : 0,
+        shows, shows ? showUs / shows : 0, showMax);
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        Serial.printf("VD: chip %d (0x%02x): osc %d, on %d, blink %d, dim %d\n",
+            j, _address[j], _osc[j], _on[j], _blink[j], _dim[j]);
+    }
+}
+
+#endif  // SID_VDISPLAY
@@ -0,0 +1,102 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Virtual display: Decodes HT16K33 traffic for debugging
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SID_VDISP_H
+#define _SID_VDISP_H
+
+#ifdef SID_VDISPLAY
+
+#include "siddisplay.h"
+
+#define VD_MAX_TRANS  40    // Max bytes per i2c transaction
+
+/*
+ * Drop-in for the Wire calls used by sidDisplay. Transactions are
+ * collected, decoded by a model of the HT16K33 chips, and then 
+ * passed on to Wire unchanged.
+ */
+class sidVWire {
+
+    public:
+
+        void begin(const uint8_t *addresses);
+
+        void    beginTransmission(uint8_t address);
+        size_t  write(uint8_t val);
+        uint8_t endTransmission();
+
+        void showTime(unsigned long us);
+
+        void getImage(uint32_t *img);
+
+    private:
+
+        bool decode(int chip, const uint8_t *data, int len);
+        bool checkFrame(uint32_t *snap);
+        void dumpFrame(unsigned long now, const uint32_t *snap);
+        void report(unsigned long now);
+
+        uint8_t  _address[SD_NUM_CHIPS];
+
+        // Per-core transaction buffer (dither task runs on core 0)
+        uint8_t  _tAddr[2];
+        uint8_t  _tBuf[2][VD_MAX_TRANS];
+        uint8_t  _tLen[2] = { 0, 0 };
+
+        // Chip model
+        uint8_t  _ram[SD_NUM_CHIPS][SD_CHIP_WORDS * 2];
+        uint8_t  _ptr[SD_NUM_CHIPS];
+        bool     _osc[SD_NUM_CHIPS];
+        bool     _on[SD_NUM_CHIPS];
+        uint8_t  _blink[SD_NUM_CHIPS];
+        uint8_t  _dim[SD_NUM_CHIPS];
+
+        // Decoded LED image, one bit per row (bit 0 = top)
+        uint32_t _img[SD_BARS];
+
+        // Statistics
+        uint32_t _trans = 0;
+        uint32_t _bytes = 0;
+        uint32_t _frames = 0;
+        uint32_t _ledChanges = 0;
+        uint32_t _shows = 0;
+        unsigned long _showUs = 0;
+        unsigned long _showMax = 0;
+        unsigned long _lastReport = 0;
+        unsigned long _lastDump = 0;
+};
+
+extern sidVWire vWire;
+
+#endif  // SID_VDISPLAY
+
+#endif
@@ -43,6 +43,7 @@
 #include "sid_settings.h"
 #include "sid_wifi.h"
 #include "sid_main.h"
+#include "sid_lat.h"
 #ifdef SID_HAVEMQTT
 #include "mqtt.h"
 #endif
@@ -1212,14 +1213,10 @@ static void mqttCallback(char *topic, byte *payload, unsigned int length)
     char tempBuf[256];
     static const char *cmdList[] = {
       "TIMETRAVEL",       // 0
-      "IDLE_0",           // 1
-      "IDLE_1",           // 2
-      "IDLE_2",           // 3
-      "IDLE_3",           // 4
-      "IDLE_4",           // 5
-      "IDLE_5",           // 6
-      "IDLE",             // 7
-      "SA",               // 8
+      "IDLE_",            // 1  IDLE_n: idle mode n
+      "IDLE",             // 2
+      "SA",               // 3
+      "LATENCY",          // 4  publish TT latency statistics
       NULL
     };
     static const char *cmdList2[] = {
@@ -1275,6 +1272,7 @@ static void mqttCallback(char *topic, byte *payload, unsigned int length)
                 networkReentry = false;
                 networkAbort = false;
                 networkLead = ETTO_LEAD;
+                lat_received(LAT_SRC_MQTT);
             }
             break;
         case 2:   // Re-entry
@@ -1326,21 +1324,26 @@ static void mqttCallback(char *topic, byte *payload, unsigned int length)
             // like TT from TCD.
             networkTimeTravel = true;
             networkTCDTT = false;
+            lat_received(LAT_SRC_MQTT);
             break;
         case 1:
-        case 2:
-        case 3:
-        case 4:
-        case 5:
-        case 6:
-            setIdleMode(i - 1);
+            if(tempBuf[5] >= '0' && tempBuf[5] <= '9') {
+                setIdleMode(atoi(&tempBuf[5]));
+            }
             break;
-        case 7:
+        case 2:
             switch_to_idle();
             break;
-        case 8:
+        case 3:
             switch_to_sa();
             break;
+        case 4:
+            {
+                char buf[512];
+                int len = lat_report(buf, sizeof(buf));
+                if(len) mqttPublish("bttf/sid/latency", buf, len);
+            }
+            break;
         }
             
     } 
@@ -52,4 +52,9 @@ void updateConfigPortalStrictValue();
 bool wifi_getIP(uint8_t& a, uint8_t& b, uint8_t& c, uint8_t& d);
 bool isIp(char *str);
 
+#ifdef SID_HAVEMQTT
+bool mqttState();
+void mqttPublish(const char *topic, const char *pl, unsigned int len);
+#endif
+
 #endif
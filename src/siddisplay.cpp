@@ -39,240 +39,103 @@
 
 #include "sid_font.h"
 
-static const uint16_t translator[10][20][2] =
-{ 
-    { 
-        { 8+2, 1<<3 },    // bar 0, top most LED   { index in buffer [0-7 chip1, 8-15 chip2], bitmask }
-        { 8+2, 1<<2 },
-        { 8+2, 1<<1 },
-        { 8+2, 1<<0 },
-        {   0, 1<<15 },
-        {   0, 1<<14 },
-        {   0, 1<<13 },
-        {   0, 1<<12 },
-        {   0, 1<<11 },
-        {   0, 1<<10 },
-        {   0, 1<<9 },
-        {   0, 1<<8 },
-        {   0, 1<<7 },
-        {   0, 1<<6 },
-        {   0, 1<<5 },
-        {   0, 1<<4 },
-        {   0, 1<<3 },
-        {   0, 1<<2 },
-        {   0, 1<<1 },
-        {   0, 1<<0 }     // bar 0, bottom LED
-    },
-    { 
-        { 8+3, 1<<3 },    // bar 1, top most LED
-        { 8+3, 1<<2 },
-        { 8+3, 1<<1 },
-        { 8+3, 1<<0 },
-        {   1, 1<<15 },
-        {   1, 1<<14 },
-        {   1, 1<<13 },
-        {   1, 1<<12 },
-        {   1, 1<<11 },
-        {   1, 1<<10 },
-        {   1, 1<<9 },
-        {   1, 1<<8 },
-        {   1, 1<<7 },
-        {   1, 1<<6 },
-        {   1, 1<<5 },
-        {   1, 1<<4 },
-        {   1, 1<<3 },
-        {   1, 1<<2 },
-        {   1, 1<<1 },
-        {   1, 1<<0 } 
-    },
-    { 
-        { 8+4, 1<<3 },    // bar 2, top most LED
-        { 8+4, 1<<2 },
-        { 8+4, 1<<1 },
-        { 8+4, 1<<0 },
-        {   2, 1<<15 },
-        {   2, 1<<14 },
-        {   2, 1<<13 },
-        {   2, 1<<12 },
-        {   2, 1<<11 },
-        {   2, 1<<10 },
-        {   2, 1<<9 },
-        {   2, 1<<8 },
-        {   2, 1<<7 },
-        {   2, 1<<6 },
-        {   2, 1<<5 },
-        {   2, 1<<4 },
-        {   2, 1<<3 },
-        {   2, 1<<2 },
-        {   2, 1<<1 },
-        {   2, 1<<0 } 
-    },
-    { 
-        { 8+5, 1<<3 },    // bar 3, top most LED
-        { 8+5, 1<<2 },
-        { 8+5, 1<<1 },
-        { 8+5, 1<<0 },
-        {   3, 1<<15 },
-        {   3, 1<<14 },
-        {   3, 1<<13 },
-        {   3, 1<<12 },
-        {   3, 1<<11 },
-        {   3, 1<<10 },
-        {   3, 1<<9 },
-        {   3, 1<<8 },
-        {   3, 1<<7 },
-        {   3, 1<<6 },
-        {   3, 1<<5 },
-        {   3, 1<<4 },
-        {   3, 1<<3 },
-        {   3, 1<<2 },
-        {   3, 1<<1 },
-        {   3, 1<<0 }
-    },
-    { 
-        { 8+6, 1<<3 },    // bar 4, top most LED
-        { 8+6, 1<<2 },
-        { 8+6, 1<<1 },
-        { 8+6, 1<<0 },
-        {   4, 1<<15 },
-        {   4, 1<<14 },
-        {   4, 1<<13 },
-        {   4, 1<<12 },
-        {   4, 1<<11 },
-        {   4, 1<<10 },
-        {   4, 1<<9 },
-        {   4, 1<<8 },
-        {   4, 1<<7 },
-        {   4, 1<<6 },
-        {   4, 1<<5 },
-        {   4, 1<<4 },
-        {   4, 1<<3 },
-        {   4, 1<<2 },
-        {   4, 1<<1 },
-        {   4, 1<<0 }
-    },
-    { 
-        { 8+7, 1<<3 },    // bar 5, top most LED
-        { 8+7, 1<<2 },
-        { 8+7, 1<<1 },
-        { 8+7, 1<<0 },
-        {   5, 1<<15 },
-        {   5, 1<<14 },
-        {   5, 1<<13 },
-        {   5, 1<<12 },
-        {   5, 1<<11 },
-        {   5, 1<<10 },
-        {   5, 1<<9 },
-        {   5, 1<<8 },
-        {   5, 1<<7 },
-        {   5, 1<<6 },
-        {   5, 1<<5 },
-        {   5, 1<<4 },
-        {   5, 1<<3 },
-        {   5, 1<<2 },
-        {   5, 1<<1 },
-        {   5, 1<<0 }
-    },
-    { 
-        { 8+2, 1<<7 },    // bar 6, top most LED
-        { 8+2, 1<<6 },
-        { 8+2, 1<<5 },
-        { 8+2, 1<<4 },
-        {   6, 1<<15 },
-        {   6, 1<<14 },
-        {   6, 1<<13 },
-        {   6, 1<<12 },
-        {   6, 1<<11 },
-        {   6, 1<<10 },
-        {   6, 1<<9 },
-        {   6, 1<<8 },
-        {   6, 1<<7 },
-        {   6, 1<<6 },
-        {   6, 1<<5 },
-        {   6, 1<<4 },
-        {   6, 1<<3 },
-        {   6, 1<<2 },
-        {   6, 1<<1 },
-        {   6, 1<<0 }
-    },
-    { 
-        { 8+3, 1<<7 },    // bar 7, top most LED
-        { 8+3, 1<<6 },
-        { 8+3, 1<<5 },
-        { 8+3, 1<<4 },
-        {   7, 1<<15 },
-        {   7, 1<<14 },
-        {   7, 1<<13 },
-        {   7, 1<<12 },
-        {   7, 1<<11 },
-        {   7, 1<<10 },
-        {   7, 1<<9 },
-        {   7, 1<<8 },
-        {   7, 1<<7 },
-        {   7, 1<<6 },
-        {   7, 1<<5 },
-        {   7, 1<<4 },
-        {   7, 1<<3 },
-        {   7, 1<<2 },
-        {   7, 1<<1 },
-        {   7, 1<<0 }
-    },
-    { 
-        { 8+4, 1<<7 },    // bar 8, top most LED
-        { 8+4, 1<<6 },
-        { 8+4, 1<<5 },
-        { 8+4, 1<<4 },
-        { 8+0, 1<<15 },
-        { 8+0, 1<<14 },
-        { 8+0, 1<<13 },
-        { 8+0, 1<<12 },
-        { 8+0, 1<<11 },
-        { 8+0, 1<<10 },
-        { 8+0, 1<<9 },
-        { 8+0, 1<<8 },
-        { 8+0, 1<<7 },
-        { 8+0, 1<<6 },
-        { 8+0, 1<<5 },
-        { 8+0, 1<<4 },
-        { 8+0, 1<<3 },
-        { 8+0, 1<<2 },
-        { 8+0, 1<<1 },
-        { 8+0, 1<<0 }
-    },
-    { 
-        { 8+5, 1<<7 },    // bar 9, top most LED
-        { 8+5, 1<<6 },
-        { 8+5, 1<<5 },
-        { 8+5, 1<<4 },
-        { 8+1, 1<<15 },
-        { 8+1, 1<<14 },
-        { 8+1, 1<<13 },
-        { 8+1, 1<<12 },
-        { 8+1, 1<<11 },
-        { 8+1, 1<<10 },
-        { 8+1, 1<<9 },
-        { 8+1, 1<<8 },
-        { 8+1, 1<<7 },
-        { 8+1, 1<<6 },
-        { 8+1, 1<<5 },
-        { 8+1, 1<<4 },
-        { 8+1, 1<<3 },
-        { 8+1, 1<<2 },
-        { 8+1, 1<<1 },
-        { 8+1, 1<<0 }
-    }   
+// Virtual display: Route i2c traffic through decoder
+#ifdef SID_VDISPLAY
+#include "sid_vdisp.h"
+#define SD_WIRE vWire
+#else
+#define SD_WIRE Wire
+#endif
+
+// Dither mode: Timer ISR wakes up the push task
+static TaskHandle_t ditherTaskHandle = NULL;
+static portMUX_TYPE ditherMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR ditherTimer_ISR()
+{
+    BaseType_t woken = pdFALSE;
+    
+    vTaskNotifyGiveFromISR(ditherTaskHandle, &woken);
+    if(woken) portYIELD_FROM_ISR();
+}
+
+/*
+ * Wiring: Each bar (column) of LEDs is connected to the chips in
+ * two segments: The lower SD_LO_ROWS rows occupy a full RAM word
+ * (bit 0 = bottom LED), the remaining top rows occupy a few bits 
+ * of another word, starting at bit hiShift (lowest bit = lowest 
+ * of the top LEDs).
+ * Buffer words 0-7 belong to the first chip, 8-15 to the second,
+ * etc.
+ * For custom builds, adjust SD_NUM_CHIPS, SD_BARS and SD_ROWS in
+ * siddisplay.h and put the wiring here.
+ */
+static const struct {
+    uint8_t lo;         // buffer word for lower rows
+    uint8_t hi;         // buffer word for top rows
+    uint8_t hiShift;    // bit position of top rows in word hi
+} wiring[] =
+{
+    { 0, 8+2, 0 },      // bar 0
+    { 1, 8+3, 0 },
+    { 2, 8+4, 0 },
+    { 3, 8+5, 0 },
+    { 4, 8+6, 0 },
+    { 5, 8+7, 0 },
+    { 6, 8+2, 4 },
+    { 7, 8+3, 4 },
+    { 8, 8+4, 4 },
+    { 9, 8+5, 4 }       // bar 9
 };
 
-// Store i2c address and display ID
+static_assert(sizeof(wiring) / sizeof(wiring[0]) == SD_BARS, "wiring table must have SD_BARS entries");
+
+/*
+ * Column access: A column mask holds one bar, bit 0 = bottom
+ * row, bit SD_ROWS-1 = top row.
+ */
+
+static inline void colOr(uint16_t *buf, int bar, uint32_t mask)
+{
+    buf[wiring[bar].lo] |= (uint16_t)mask;
+    buf[wiring[bar].hi] |= ((mask >> SD_LO_ROWS) & SD_HI_MASK) << wiring[bar].hiShift;
+}
+
+static inline void colClear(uint16_t *buf, int bar, uint32_t mask)
+{
+    buf[wiring[bar].lo] &= ~(uint16_t)mask;
+    buf[wiring[bar].hi] &= ~(((mask >> SD_LO_ROWS) & SD_HI_MASK) << wiring[bar].hiShift);
+}
+
+static inline uint32_t colGet(const uint16_t *buf, int bar)
+{
+    return buf[wiring[bar].lo] | 
+           (((uint32_t)(buf[wiring[bar].hi] >> wiring[bar].hiShift) & SD_HI_MASK) << SD_LO_ROWS);
+}
+
+// Store i2c addresses
+#if SD_NUM_CHIPS == 2
 sidDisplay::sidDisplay(uint8_t address1, uint8_t address2)
 {
     _address[0] = address1;
     _address[1] = address2;
 }
+#endif
+
+sidDisplay::sidDisplay(const uint8_t *addresses)
+{
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        _address[j] = addresses[j];
+    }
+}
 
 // Start the display
 void sidDisplay::begin()
 {
+    #ifdef SID_VDISPLAY
+    vWire.begin(_address);
+    #endif
+    
     directCmd(0x20 | 1);    // turn on oscillator
 
     clearBuf();             // clear buffer
@@ -295,14 +158,14 @@ void sidDisplay::off()
 
 void sidDisplay::lampTest()
 { 
-    for(int j = 0; j < 2; j++) {
-        Wire.beginTransmission(_address[j]);  
-        Wire.write(0x00);  // start address
-        for(int i = 0; i < SD_BUF_SIZE / 2; i++) {
-            Wire.write(0xff);
-            Wire.write(0xff);
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        SD_WIRE.beginTransmission(_address[j]);  
+        SD_WIRE.write(0x00);  // start address
+        for(int i = 0; i < SD_CHIP_WORDS; i++) {
+            SD_WIRE.write(0xff);
+            SD_WIRE.write(0xff);
         }
-        Wire.endTransmission();
+        SD_WIRE.endTransmission();
     }
 }
 
@@ -313,11 +176,13 @@ void sidDisplay::clearBuf()
     for(int i = 0; i < SD_BUF_SIZE; i++) {
         _displayBuffer[i] = 0;
     }
+    memset(_dimBuffer, 0, sizeof(_dimBuffer));
 }
 
 // Set display brightness
 // Valid brightness levels are 0 to 15.
 // 255 sets it to previous level
+// Cancels a running fade.
 uint8_t sidDisplay::setBrightness(uint8_t level, bool setInitial)
 {
     if(level == 255)
@@ -335,12 +200,15 @@ void sidDisplay::resetBrightness()
     _brightness = setBrightnessDirect(_origBrightness);
 }
 
+// Set brightness without changing the stored level. 
+// Cancels a running fade.
 uint8_t sidDisplay::setBrightnessDirect(uint8_t level)
 {
     if(level > 15)
         level = 15;
 
-    directCmd(0xe0 | level);
+    stopFade();
+    sendLevel(level);
 
     return level;
 }
@@ -350,6 +218,109 @@ uint8_t sidDisplay::getBrightness()
     return _brightness;
 }
 
+/*
+ * Brightness animator
+ * 
+ * Fades from the current level to the target within duration ms,
+ * following an easing curve. Advanced by the frame clock through 
+ * fadeLoop(); the dimming command is only sent to the chips if the
+ * level actually changes. Starting a new fade replaces a running 
+ * one; setting the brightness explicitly cancels it.
+ */
+
+void sidDisplay::fadeTo(uint8_t level, uint16_t duration, uint8_t ease, sdFadeCallback cb)
+{
+    if(level > 15) level = 15;
+
+    _fadeFrom = (_curLevel > 15) ? _brightness : _curLevel;
+    _fadeTo = level;
+    _fadeDur = duration;
+    _fadeEase = ease;
+    _fadeCB = cb;
+    _fadeStart = millis();
+    _fading = true;
+}
+
+// Fade to stored brightness level
+void sidDisplay::fadeIn(uint16_t duration, uint8_t ease, sdFadeCallback cb)
+{
+    fadeTo(_brightness, duration, ease, cb);
+}
+
+void sidDisplay::fadeOut(uint16_t duration, uint8_t ease, sdFadeCallback cb)
+{
+    fadeTo(0, duration, ease, cb);
+}
+
+void sidDisplay::stopFade()
+{
+    _fading = false;
+    _fadeCB = NULL;
+}
+
+bool sidDisplay::isFading()
+{
+    return _fading;
+}
+
+void sidDisplay::fadeLoop(unsigned long now)
+{
+    unsigned long elapsed;
+    int t, diff;
+
+    if(!_fading)
+        return;
+
+    elapsed = now - _fadeStart;
+
+    if(elapsed >= _fadeDur) {
+        sdFadeCallback cb = _fadeCB;
+        sendLevel(_fadeTo);
+        stopFade();
+        if(cb) cb();
+        return;
+    }
+
+    t = ease(_fadeEase, elapsed, _fadeDur);
+
+    diff = (int)_fadeTo - (int)_fadeFrom;
+    sendLevel(_fadeFrom + ((diff * t) / 256));
+}
+
+// Progress 0-256 after elapsed of duration ms, eased
+int sidDisplay::ease(uint8_t ease, unsigned long elapsed, unsigned long duration)
+{
+    int t;
+
+    if(elapsed >= duration)
+        return 256;
+    
+    t = (elapsed << 8) / duration;
+    
+    switch(ease) {
+    case SD_EASE_IN:
+        t = (t * t) >> 8;
+        break;
+    case SD_EASE_OUT:
+        t = 256 - (((256 - t) * (256 - t)) >> 8);
+        break;
+    case SD_EASE_INOUT:
+        t = (t < 128) ? ((t * t) >> 7) : 256 - (((256 - t) * (256 - t)) >> 7);
+        break;
+    }
+
+    return t;
+}
+
+// Send dimming command, if level has changed
+void sidDisplay::sendLevel(uint8_t level)
+{
+    if(level != _curLevel) {
+        directCmd(0xe0 | level);
+        _curLevel = level;
+    }
+}
+
 // Draw bar into buffer, do NOT call show
 void sidDisplay::drawBarWithHeight(uint8_t bar, uint8_t height)
 {
@@ -357,50 +328,31 @@ void sidDisplay::drawBarWithHeight(uint8_t bar, uint8_t height)
     // Draw bar with given height
 
     if(height > 127) height = 0;
-    if(height > 20) height = 20;
+    if(height > SD_ROWS) height = SD_ROWS;
 
-    if(height < 20) {
-        for(int i = 0; i < 20 - height; i++) {
-            _displayBuffer[translator[bar][i][0]] &= ~(translator[bar][i][1]);
-        }
-    }
-    if(height > 0) {
-        for(int i = 20 - height; i < 20; i++) {
-            _displayBuffer[translator[bar][i][0]] |= translator[bar][i][1];
-        }
-    }
+    colClear(_displayBuffer, bar, SD_COL_MASK);
+    colOr(_displayBuffer, bar, (1UL << height) - 1);
 }
 
 // Draw bar into buffer, do NOT call show
 void sidDisplay::drawBar(uint8_t bar, uint8_t bottom, uint8_t top)
 {
-    // Clear bar
+    // Clear bar above top
     // Draw bar from top to bottom (0-19, 0=bottom)
 
-    if(top > 19) top = 19;
-    if(bottom > 19) bottom = 19;
+    if(top > SD_ROWS - 1) top = SD_ROWS - 1;
+    if(bottom > SD_ROWS - 1) bottom = SD_ROWS - 1;
     if(bottom > top) bottom = top;
 
-    if(top < 19) {
-        for(int i = 0; i <= 19-top; i++) {
-            _displayBuffer[translator[bar][i][0]] &= ~(translator[bar][i][1]);
-        }
-    }
-    if(bottom > 0) {
-        for(int i = 19; i <= 19-bottom; i--) {
-            _displayBuffer[translator[bar][i][0]] &= ~(translator[bar][i][1]);
-        }
-    }
-    for(int i = 19-top; i <= 19-bottom; i++) {
-        _displayBuffer[translator[bar][i][0]] |= translator[bar][i][1];
-    }
+    uint32_t toTop = (2UL << top) - 1;
+
+    colClear(_displayBuffer, bar, SD_COL_MASK & ~toTop);
+    colOr(_displayBuffer, bar, toTop & ~((1UL << bottom) - 1));
 }
 
 void sidDisplay::clearBar(uint8_t bar)
 {
-    for(int i = 0; i <= 19; i++) {
-        _displayBuffer[translator[bar][i][0]] &= ~(translator[bar][i][1]);
-    }
+    colClear(_displayBuffer, bar, SD_COL_MASK);
 }
 
 // Draw dot into buffer, do NOT call show
@@ -408,181 +360,380 @@ void sidDisplay::drawDot(uint8_t bar, uint8_t dot_y)
 {
     // Do not clear bar
     // Draw dot at dot_y (0 = bottom)
-    if(dot_y > 19) dot_y = 19;
+    if(dot_y > SD_ROWS - 1) dot_y = SD_ROWS - 1;
 
-    _displayBuffer[translator[bar][19-dot_y][0]] |= translator[bar][19-dot_y][1];
+    colOr(_displayBuffer, bar, 1UL << dot_y);
 }
 
-void sidDisplay::drawFieldAndShow(uint8_t *fieldData)
+// Draw dot with intensity level (0-255) into buffer, do NOT call show
+// In dither mode, the dot is lit in a share of subframes according
+// to level; it is only drawn for the next frame, ie cleared after show().
+// Without dither mode, any level > 0 draws a normal dot.
+void sidDisplay::drawDotLevel(uint8_t bar, uint8_t dot_y, uint8_t level)
 {
-    // Draw entire field. Data is 0 or 1, organized in lines
-    for(int i = 0, k = 0; i < 20; i++, k += 10) {
-        for(int j = 0; j < 10; j++) {
-            if(fieldData[k+j]) {
-                _displayBuffer[translator[j][i][0]] |= translator[j][i][1];
-            } else {
-                _displayBuffer[translator[j][i][0]] &= ~(translator[j][i][1]);
-            }
+    if(!level)
+        return;
+        
+    if(!_ditherActive) {
+        drawDot(bar, dot_y);
+        return;
+    }
+    
+    if(dot_y > SD_ROWS - 1) dot_y = SD_ROWS - 1;
+
+    int n = (level * _ditherSF + 128) >> 8;
+    if(!n) n = 1;
+
+    for(int i = 0; i < n; i++) {
+        colOr(_dimBuffer[i], bar, 1UL << dot_y);
+    }
+}
+
+// Draw entire field into buffer, do NOT call show
+void sidDisplay::drawField(uint8_t *fieldData)
+{
+    // Data is 0 or 1, organized in lines (top line first)
+    for(int j = 0; j < SD_BARS; j++) {
+        uint32_t col = 0;
+        for(int i = 0, k = j; i < SD_ROWS; i++, k += SD_BARS) {
+            col <<= 1;
+            if(fieldData[k]) col |= 1;
         }
+        colClear(_displayBuffer, j, SD_COL_MASK);
+        colOr(_displayBuffer, j, col);
     }
+}
+
+// Data is one bit mask per line (top line first), bit n = bar n
+void sidDisplay::drawFieldRows(const uint16_t *rows)
+{
+    for(int j = 0; j < SD_BARS; j++) {
+        uint32_t col = 0;
+        for(int i = 0; i < SD_ROWS; i++) {
+            col = (col << 1) | ((rows[i] >> j) & 1);
+        }
+        colClear(_displayBuffer, j, SD_COL_MASK);
+        colOr(_displayBuffer, j, col);
+    }
+}
+
+void sidDisplay::drawFieldAndShow(uint8_t *fieldData)
+{
+    drawField(fieldData);
     show();
 }
 
 void sidDisplay::drawLetterAndShow(char alpha, int x, int y)
 {
-    uint8_t field[20*10] = { 0 };
-    int w = 10, h = 10, fx = 0, fy = 0, a = 0x200, s;
+    drawLetter(alpha, x, y);
+    show();
+}
 
-    if(x < -9 || x > 9 || y < -9 || y > 19) {
-        clearDisplayDirect();
-        return;
+// Draw letter into otherwise empty buffer, do NOT call show
+void sidDisplay::drawLetter(char alpha, int x, int y)
+{
+    memset(_displayBuffer, 0, sizeof(_displayBuffer));
+
+    if(!addLetter(alpha, x, y)) {
+        clearBuf();
     }
-    
-    if(alpha >= '0' && alpha <= '9') {
-        alpha -= '0';
-    } else if(alpha >= 'A' && alpha <= 'Z') {
-        alpha -= ('A' - 10);
-    } else if(alpha >= 'a' && alpha <= 'z') {
-        alpha -= ('a' - 10);
-    } else if(alpha == '.') {
-        alpha = 36;
-    } else if(alpha == '&') {
-        alpha = 37;
-    } else if(alpha == '*') {
-        alpha = 38;
-    } else if(alpha == '#') {
-        alpha = 39;
-    } else if(alpha == '^') {
-        alpha = 40;
-    } else if(alpha == '$') {
-        alpha = 41;
-    } else if(alpha == '<') {
-        alpha = 42;
-    } else if(alpha == '>') {
-        alpha = 43;
-    } else if(alpha == '~') {
-        alpha = 44;
-    } else {
-        clearDisplayDirect();   
-        return;
+}
+
+// Add letter to buffer, do NOT call show
+// Returns false if there is no glyph for alpha, or position is off-screen
+bool sidDisplay::addLetter(char alpha, int x, int y)
+{
+    const uint16_t *font;
+    uint8_t g;
+    int shift = SD_ROWS - 10 - y;   // glyph bottom row -> column bit
+
+    if(x < -9 || x >= SD_BARS || y < -9 || y >= SD_ROWS || 
+       (uint8_t)alpha > 127 || (g = glyphIdx[(uint8_t)alpha]) == 0xff) {
+        return false;
     }
 
-    if(x < 0) {
-        fx = -x;
-        a >>= fx;
-        w = 10 - fx;
-        x = 0;
-    } else if(x > 0) {
-        w = 10 - x;
+    font = alphaCols[g];
+    for(int c = 0; c < 10; c++, x++) {
+        if(x >= 0 && x < SD_BARS) {
+            colOr(_displayBuffer, x, (shift >= 0) ? ((uint32_t)font[c] << shift) : (font[c] >> -shift));
+        }
     }
-    if(y < 0) {
-        fy = -y;
-        h = 10 - fy;
-        y = 0;
-    } else if(y > (20-10)) {       
-        h = 20 - y;           
+
+    return true;
+}
+
+// Clear pixels of letter in buffer, do NOT call show
+void sidDisplay::drawLetterMask(char alpha, int x, int y)
+{
+    const uint8_t *font;
+    uint8_t g;
+    int shift = SD_ROWS - 8 - y;    // glyph bottom row -> column bit
+
+    if(x < -7 || x >= SD_BARS || y < -7 || y >= SD_ROWS ||
+       (uint8_t)alpha > 127 || (g = glyphIdx8[(uint8_t)alpha]) == 0xff) {
+        return;
     }
 
-    for(int yy = fy; yy < h; yy++, y++) {
-        uint16_t font = alphaChars[alpha][yy];
-        int xxx = x;
-        for(int xx = fx, s = a; xx < w; xx++, s >>= 1, xxx++) {
-            if(font & s) {
-                field[(y*10) + xxx] = 1;
-            }
+    font = alphaCols8[g];
+    for(int c = 0; c < 8; c++, x++) {
+        if(x >= 0 && x < SD_BARS) {
+            colClear(_displayBuffer, x, (shift >= 0) ? ((uint32_t)font[c] << shift) : (font[c] >> -shift));
         }
     }
-    drawFieldAndShow(field);
 }
 
-void sidDisplay::drawLetterMask(char alpha, int x, int y)
+// Show the buffer
+// In dither mode, only latch the frame; it is put on
+// the display by the push task.
+void sidDisplay::show()
 {
-    uint8_t field[20*10] = { 0 };
-    int w = 8, h = 8, fx = 0, fy = 0, a = 0x80, s;
+    _showRequested = false;
 
-    if(x < -7 || x > 9 || y < -7 || y > 19) {
+    if(_markShow) {
+        _markShow = false;
+        _markedShowUs = micros();
+        _markedShow = true;
+    }
+    
+    if(_ditherActive) {
+        portENTER_CRITICAL(&ditherMux);
+        for(int j = 0; j < _ditherSF; j++) {
+            for(int i = 0; i < SD_BUF_SIZE; i++) {
+                _sfBuffer[j][i] = _displayBuffer[i] | _dimBuffer[j][i];
+            }
+        }
+        portEXIT_CRITICAL(&ditherMux);
+        memset(_dimBuffer, 0, sizeof(_dimBuffer));
         return;
     }
     
-    if(alpha >= '0' && alpha <= '9') {
-        alpha -= '0';
-    } else if(alpha >= 'A' && alpha <= 'Z') {
-        alpha -= ('A' - 10);
-    } else if(alpha >= 'a' && alpha <= 'z') {
-        alpha -= ('a' - 10);
-    } else if(alpha == '.') {
-        alpha = 36;
-    } else if(alpha == '#') {
-        alpha = 37;
-    } else if(alpha >= '$' && alpha <= '\'') {
-        alpha -= '$';
-        alpha += 38;
-    } else { 
+    #ifdef SID_VDISPLAY
+    unsigned long us = micros();
+    #endif
+    
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        pushBuffer(j, &_displayBuffer[j * SD_CHIP_WORDS]);
+    }
+
+    #ifdef SID_VDISPLAY
+    vWire.showTime(micros() - us);
+    #endif
+}
+
+// Request showing the buffer at the next frame clock tick
+void sidDisplay::requestShow()
+{
+    _showRequested = true;
+}
+
+// Show the buffer if requested (called by frame clock)
+void sidDisplay::flush()
+{
+    if(_showRequested) {
+        _showRequested = false;
+        show();
+    }
+}
+
+// Timestamp the next show(). In dither mode, this is when the
+// buffer is latched; it reaches the chips with the next subframe.
+void sidDisplay::markNextShow()
+{
+    _markedShow = false;
+    _markShow = true;
+}
+
+bool sidDisplay::getMarkedShow(unsigned long &us)
+{
+    if(!_markedShow)
+        return false;
+
+    _markedShow = false;
+    us = _markedShowUs;
+    return true;
+}
+
+void sidDisplay::clearDisplayDirect()
+{
+    if(_ditherActive) {
+        portENTER_CRITICAL(&ditherMux);
+        memset(_sfBuffer, 0, sizeof(_sfBuffer));
+        portEXIT_CRITICAL(&ditherMux);
         return;
     }
+    
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        SD_WIRE.beginTransmission(_address[j]);
+        SD_WIRE.write(0x00);
+        for(int i = 0; i < SD_CHIP_WORDS; i++) {
+            SD_WIRE.write(0x00);
+            SD_WIRE.write(0x00);
+        }
+        SD_WIRE.endTransmission();
+    }
+}
 
-    if(x < 0) {
-        fx = -x;
-        a >>= fx;
-        w = 8 - fx;
-        x = 0;
-    } else if(x > 2) {
-        w = 8 - x;
+#ifdef SID_VDISPLAY
+// Check if LED is lit in (chip RAM) buffer; used by virtual display
+// dot_y: 0 = top
+bool sidDisplay::isLit(const uint16_t *buf, uint8_t bar, uint8_t dot_y)
+{
+    return !!(colGet(buf, bar) & (1UL << (SD_ROWS - 1 - dot_y)));
+}
+#endif
+
+void sidDisplay::directCmd(uint8_t val)
+{
+    for(int j = 0; j < SD_NUM_CHIPS; j++) {
+        SD_WIRE.beginTransmission(_address[j]);
+        SD_WIRE.write(val);
+        SD_WIRE.endTransmission();
     }
-    if(y < 0) {
-        fy = -y;
-        h = 8 - fy;
-        y = 0;
-    } else if(y > (20-8)) {       
-        h = 20 - y;           
+}
+
+void sidDisplay::pushBuffer(int chip, const uint16_t *buf)
+{
+    SD_WIRE.beginTransmission(_address[chip]);
+    SD_WIRE.write(0x00);
+    for(int i = 0; i < SD_CHIP_WORDS; i++) {
+        uint16_t t = *buf++;
+        SD_WIRE.write(t & 0xff);
+        SD_WIRE.write(t >> 8);
     }
+    SD_WIRE.endTransmission();
+}
 
-    for(int yy = fy; yy < h; yy++, y++) {
-        uint8_t font = alphaChars8[alpha][yy];
-        int xxx = x;
-        for(int xx = fx, s = a; xx < w; xx++, s >>= 1, xxx++) {
-            if(font & s) {
-                _displayBuffer[translator[xxx][y][0]] &= ~(translator[xxx][y][1]);
-            }
+/*
+ * Dither mode
+ *
+ * Each frame is split into subFrames (2-4) subframes, which are 
+ * put on the display by a task woken up by a hardware timer at 
+ * frameRate * subFrames Hz. Dots drawn with drawDotLevel() are 
+ * only lit in some of the subframes, resulting in additional
+ * perceived intensity levels. Chip RAM is only re-written if the 
+ * subframe differs from what the chip currently shows, so without 
+ * dimmed dots, there is no additional i2c traffic.
+ * At 400kHz, pushing one chip takes ~0.5ms, so 2 chips at 3 x 100Hz
+ * is well within reach of the bus.
+ */
+
+bool sidDisplay::startDither(uint8_t timerNo, uint8_t subFrames, uint16_t frameRate)
+{
+    if(_ditherActive)
+        return true;
+
+    if(subFrames < 2) subFrames = 2;
+    if(subFrames > SD_DITHER_MAX_SF) subFrames = SD_DITHER_MAX_SF;
+    if(frameRate < 25) frameRate = 25;
+
+    if(!ditherTaskHandle) {
+        if(xTaskCreatePinnedToCore(ditherTask, "SIDDither", 2048, (void *)this, 2, 
+                                   &ditherTaskHandle, 0) != pdPASS) {
+            ditherTaskHandle = NULL;
+            #ifdef SID_DBG
+            Serial.println("startDither: Failed to create push task");
+            #endif
+            return false;
         }
     }
+
+    _ditherSF = subFrames;
+    _sfIdx = 0;
+    _sfCnt = _sfRate = 0;
+    _sfRateNow = millis();
+    
+    memset(_dimBuffer, 0, sizeof(_dimBuffer));
+    for(int j = 0; j < SD_DITHER_MAX_SF; j++) {
+        memcpy(_sfBuffer[j], _displayBuffer, sizeof(_displayBuffer));
+    }
+    // Force re-write of chip RAM on first push
+    memset(_sfLast, 0xff, sizeof(_sfLast));
+
+    __atomic_store_n(&_ditherActive, true, __ATOMIC_RELEASE);
+
+    if(!_ditherTimer) {
+        _ditherTimer = timerBegin(timerNo, 80, true);   // 1MHz
+        timerAttachInterrupt(_ditherTimer, &ditherTimer_ISR, true);
+    }
+    timerAlarmWrite(_ditherTimer, 1000000 / (frameRate * subFrames), true);
+    timerAlarmEnable(_ditherTimer);
+
+    return true;
 }
 
-// Show the buffer
-void sidDisplay::show()
+void sidDisplay::stopDither()
 {
-    uint16_t *tp = &_displayBuffer[0];
+    if(!_ditherActive)
+        return;
+
+    timerAlarmDisable(_ditherTimer);
+    __atomic_store_n(&_ditherActive, false, __ATOMIC_RELEASE);
     
-    for(int j = 0; j < 2; j++) {
-        Wire.beginTransmission(_address[j]);
-        Wire.write(0x00);
-        for(int i = 0; i < SD_BUF_SIZE / 2; i++) {
-            uint16_t t = *tp++;
-            Wire.write(t & 0xff);
-            Wire.write(t >> 8);
-        }
-        Wire.endTransmission();
+    // Wake push task and wait until it acknowledges; it only does
+    // so between subframes, and sees _ditherActive false afterwards,
+    // so the bus is ours once the flag is cleared.
+    __atomic_store_n(&_ditherStopReq, true, __ATOMIC_RELEASE);
+    xTaskNotifyGive(ditherTaskHandle);
+    while(__atomic_load_n(&_ditherStopReq, __ATOMIC_ACQUIRE)) {
+        delay(1);
     }
+    
+    show();
 }
 
-void sidDisplay::clearDisplayDirect()
+// Returns number of subframes pushed per second
+uint32_t sidDisplay::getDitherRate()
 {
-    for(int j = 0; j < 2; j++) {
-        Wire.beginTransmission(_address[j]);
-        Wire.write(0x00);
-        for(int i = 0; i < SD_BUF_SIZE / 2; i++) {
-            Wire.write(0x00);
-            Wire.write(0x00);
+    return _ditherActive ? _sfRate : 0;
+}
+
+void sidDisplay::ditherTask(void *arg)
+{
+    sidDisplay *disp = (sidDisplay *)arg;
+    
+    for(;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if(__atomic_load_n(&disp->_ditherActive, __ATOMIC_ACQUIRE)) {
+            disp->ditherPush();
+        }
+        if(__atomic_load_n(&disp->_ditherStopReq, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&disp->_ditherStopReq, false, __ATOMIC_RELEASE);
         }
-        Wire.endTransmission();
     }
 }
 
-void sidDisplay::directCmd(uint8_t val)
+void sidDisplay::ditherPush()
 {
-    for(int j = 0; j < 2; j++) {
-        Wire.beginTransmission(_address[j]);
-        Wire.write(val);
-        Wire.endTransmission();
+    uint16_t buf[SD_BUF_SIZE];
+    unsigned long now;
+
+    portENTER_CRITICAL(&ditherMux);
+    memcpy(buf, _sfBuffer[_sfIdx], sizeof(buf));
+    portEXIT_CRITICAL(&ditherMux);
+
+    for(int j = 0, k = 0; j < SD_NUM_CHIPS; j++, k += SD_CHIP_WORDS) {
+        if(memcmp(&buf[k], &_sfLast[k], SD_CHIP_WORDS * sizeof(uint16_t))) {
+            pushBuffer(j, &buf[k]);
+            memcpy(&_sfLast[k], &buf[k], SD_CHIP_WORDS * sizeof(uint16_t));
+        }
+    }
+    
+    _sfIdx++;
+    if(_sfIdx >= _ditherSF) _sfIdx = 0;
+
+    // Measure achieved subframe rate
+    _sfCnt++;
+    now = millis();
+    if(now - _sfRateNow >= 1000) {
+        _sfRate = _sfCnt * 1000 / (now - _sfRateNow);
+        _sfCnt = 0;
+        _sfRateNow = now;
+        #ifdef SID_DBG
+        static int dbgCnt = 0;
+        if(++dbgCnt >= 30) {
+            Serial.printf("Dither: %lu subframes/s\n", (unsigned long)_sfRate);
+            dbgCnt = 0;
+        }
+        #endif
     }
 }
@@ -33,13 +33,51 @@
 #ifndef _SIDDISPLAY_H
 #define _SIDDISPLAY_H
 
-#define SD_BUF_SIZE   16  // Buffer size in words (16bit)
+/*
+ * Geometry: Number of HT16K33 chips, bars (columns) and LEDs per bar.
+ * Default is the SID: 2 chips, 10 bars of 20 LEDs. For custom builds,
+ * these can be changed; the wiring table in siddisplay.cpp must match.
+ */
+#ifndef SD_NUM_CHIPS
+#define SD_NUM_CHIPS   2
+#endif
+#ifndef SD_BARS
+#define SD_BARS       10
+#endif
+#ifndef SD_ROWS
+#define SD_ROWS       20
+#endif
+
+#if SD_ROWS <= 16 || SD_ROWS > 31
+#error "SD_ROWS must be 17-31"
+#endif
+
+#define SD_CHIP_WORDS  8                              // RAM words (16bit) per chip
+#define SD_BUF_SIZE   (SD_NUM_CHIPS * SD_CHIP_WORDS)  // Buffer size in words (16bit)
+
+#define SD_LO_ROWS    16                              // Rows in lower segment (full word)
+#define SD_HI_MASK    ((1UL << (SD_ROWS - SD_LO_ROWS)) - 1)
+#define SD_COL_MASK   ((1UL << SD_ROWS) - 1)
+
+#define SD_DITHER_MAX_SF  4   // Max number of subframes per frame in dither mode
+
+// Easing curves for brightness fades and other animations
+#define SD_EASE_LINEAR  0
+#define SD_EASE_IN      1     // slow start
+#define SD_EASE_OUT     2     // slow end
+#define SD_EASE_INOUT   3
+
+// Called when a fade has finished (not when cancelled)
+typedef void (*sdFadeCallback)();
 
 class sidDisplay {
 
     public:
 
+        #if SD_NUM_CHIPS == 2
         sidDisplay(uint8_t address1, uint8_t address2);
+        #endif
+        sidDisplay(const uint8_t *addresses);
         void begin();
         void on();
         void off();
@@ -52,8 +90,21 @@ class sidDisplay {
         void    resetBrightness();
         uint8_t setBrightnessDirect(uint8_t level);
         uint8_t getBrightness();
+
+        void fadeTo(uint8_t level, uint16_t duration, uint8_t ease = SD_EASE_LINEAR, sdFadeCallback cb = NULL);
+        void fadeIn(uint16_t duration, uint8_t ease = SD_EASE_LINEAR, sdFadeCallback cb = NULL);
+        void fadeOut(uint16_t duration, uint8_t ease = SD_EASE_LINEAR, sdFadeCallback cb = NULL);
+        void stopFade();
+        bool isFading();
+        void fadeLoop(unsigned long now);
+
+        static int ease(uint8_t ease, unsigned long elapsed, unsigned long duration);
         
         void show();
+        void requestShow();
+        void flush();
+        void markNextShow();
+        bool getMarkedShow(unsigned long &us);
 
         void clearDisplayDirect();
 
@@ -61,22 +112,72 @@ class sidDisplay {
         void drawBarWithHeight(uint8_t bar, uint8_t height);
         void clearBar(uint8_t bar);
         void drawDot(uint8_t bar, uint8_t dot_y);
+        void drawDotLevel(uint8_t bar, uint8_t dot_y, uint8_t level);
 
+        void drawField(uint8_t *fieldData);
         void drawFieldAndShow(uint8_t *fieldData);
+        void drawFieldRows(const uint16_t *rows);
 
+        void drawLetter(char alpha, int x = 0, int y = 8);
         void drawLetterAndShow(char alpha, int x = 0, int y = 8);
+        bool addLetter(char alpha, int x, int y);
         void drawLetterMask(char alpha, int x, int y);
 
+        bool     startDither(uint8_t timerNo, uint8_t subFrames = 3, uint16_t frameRate = 100);
+        void     stopDither();
+        uint32_t getDitherRate();
+
+        #ifdef SID_VDISPLAY
+        static bool isLit(const uint16_t *buf, uint8_t bar, uint8_t dot_y);
+        #endif
+
     private:
         void directCmd(uint8_t val);
+        void sendLevel(uint8_t level);
+        void pushBuffer(int chip, const uint16_t *buf);
+
+        static void ditherTask(void *arg);
+        void        ditherPush();
         
-        uint8_t _address[2] = { 0, 0 };
+        uint8_t _address[SD_NUM_CHIPS];
 
         uint8_t _brightness = 15;     // current display brightness
         uint8_t _origBrightness = 15; // value from settings
+        uint8_t _curLevel = 0xff;     // level last sent to chips
+
+        // Brightness animator
+        bool           _fading = false;
+        uint8_t        _fadeFrom = 0;
+        uint8_t        _fadeTo = 0;
+        uint8_t        _fadeEase = SD_EASE_LINEAR;
+        uint16_t       _fadeDur = 0;
+        unsigned long  _fadeStart = 0;
+        sdFadeCallback _fadeCB = NULL;
         
         uint16_t _displayBuffer[SD_BUF_SIZE];
 
+        bool     _showRequested = false;
+
+        // One-shot timestamp of next show() (latency statistics)
+        bool          _markShow = false;
+        bool          _markedShow = false;
+        unsigned long _markedShowUs = 0;
+
+        // Dither mode: Dimmed dots are drawn into the first n subframe
+        // planes; show() latches full + dimmed planes into the subframe
+        // buffers which are pushed to the chips by a timer-driven task.
+        bool          _ditherActive = false;
+        bool          _ditherStopReq = false;
+        uint8_t       _ditherSF = 3;
+        uint8_t       _sfIdx = 0;
+        hw_timer_t    *_ditherTimer = NULL;
+        uint16_t      _dimBuffer[SD_DITHER_MAX_SF][SD_BUF_SIZE];
+        uint16_t      _sfBuffer[SD_DITHER_MAX_SF][SD_BUF_SIZE];
+        uint16_t      _sfLast[SD_BUF_SIZE];
+        uint32_t      _sfCnt = 0;
+        uint32_t      _sfRate = 0;
+        unsigned long _sfRateNow = 0;
+
 };
 
 #endif
@@ -0,0 +1,370 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test: Display through the HT16K33 model
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <time.h>
+
+#include "shim.h"
+#include "siddisplay.h"
+#include "sid_vdisp.h"
+
+/*
+ * Draws a set of scenes through sidDisplay, with the i2c traffic
+ * decoded by the virtual display (sid_vdisp, SID_VDISPLAY) and the
+ * bus replaced by the shim's model (shim/Wire.h). Checks
+ * - the decoded LED image against the drawing calls (bars, dots, 
+ *   rows, lamp test), and every scene against the golden ASCII 
+ *   frames in the given file (-u rewrites the file),
+ * - writes each scene as a PPM image into the directory given
+ *   as the last argument, if any,
+ * and reports the cost of show(): host CPU time (chip model 
+ * included) and the time the transactions take on the modelled
+ * 400kHz bus. Nothing is passed on to real chips, so the figures
+ * are those of the bus model alone. Built once per SD_NUM_CHIPS,
+ * always with the SID's wiring table (siddisplay.cpp): Only the
+ * first two chips are wired to LEDs, chips 3-8 are written to, but
+ * only ever receive blank words. The image checks therefore don't
+ * cover them.
+ */
+
+#define SHOW_RUNS   20000
+#define MAX_SCENES  16
+
+#define PPM_LED     6     // LED size in pixels
+#define PPM_GAP     2
+
+#if SD_NUM_CHIPS > 8
+#error "Up to 8 HT16K33 on one bus"
+#endif
+
+// Chip addresses; the SID has 0x74 and 0x72
+static const uint8_t addresses[8] = { 0x74, 0x72, 0x70, 0x71, 0x73, 0x75, 0x76, 0x77 };
+
+static sidDisplay disp(addresses);
+
+static struct {
+    char     name[16];
+    uint32_t img[SD_BARS];
+} golden[MAX_SCENES];
+static int numGolden = 0;
+
+static int errors = 0;
+
+static double seconds()
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void printFrame(const uint32_t *img, FILE *f)
+{
+    for(int y = 0; y < SD_ROWS; y++) {
+        fputc('|', f);
+        for(int x = 0; x < SD_BARS; x++) {
+            fputc((img[x] & (1 << y)) ? '#' : '.', f);
+        }
+        fputs("|\n", f);
+    }
+}
+
+static void printDiff(const uint32_t *want, const uint32_t *got)
+{
+    for(int y = 0; y < SD_ROWS; y++) {
+        printf("  |");
+        for(int x = 0; x < SD_BARS; x++) {
+            putchar((want[x] & (1 << y)) ? '#' : '.');
+        }
+        printf("|  |");
+        for(int x = 0; x < SD_BARS; x++) {
+            bool w = !!(want[x] & (1 << y)), g = !!(got[x] & (1 << y));
+            putchar((w == g) ? (g ? '#' : '.') : (g ? '+' : '-'));
+        }
+        printf("|\n");
+    }
+}
+
+static int loadGolden(const char *fn)
+{
+    FILE *f = fopen(fn, "r");
+    char line[256];
+    int y = 0;
+
+    if(!f)
+        return -1;
+
+    numGolden = 0;
+    while(fgets(line, sizeof(line), f)) {
+        if(line[0] == '#') {
+            if(numGolden >= MAX_SCENES) break;
+            sscanf(line + 1, "%15s", golden[numGolden].name);
+            memset(golden[numGolden].img, 0, sizeof(golden[0].img));
+            numGolden++;
+            y = 0;
+        } else if(line[0] == '|' && numGolden && y < SD_ROWS) {
+            for(int x = 0; x < SD_BARS && line[x + 1] && line[x + 1] != '|'; x++) {
+                if(line[x + 1] == '#') golden[numGolden - 1].img[x] |= (1 << y);
+            }
+            y++;
+        }
+    }
+    fclose(f);
+
+    return numGolden;
+}
+
+static void writePPM(const char *dir, const char *name, const uint32_t *img)
+{
+    char fn[512];
+    FILE *f;
+    int w = SD_BARS * (PPM_LED + PPM_GAP) + PPM_GAP;
+    int h = SD_ROWS * (PPM_LED + PPM_GAP) + PPM_GAP;
+
+    snprintf(fn, sizeof(fn), "%s/disp_%s.ppm", dir, name);
+    if(!(f = fopen(fn, "wb"))) {
+        printf("%s: cannot write\n", fn);
+        errors++;
+        return;
+    }
+
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for(int py = 0; py < h; py++) {
+        for(int px = 0; px < w; px++) {
+            int x = (px - PPM_GAP) / (PPM_LED + PPM_GAP), xo = (px - PPM_GAP) % (PPM_LED + PPM_GAP);
+            int y = (py - PPM_GAP) / (PPM_LED + PPM_GAP), yo = (py - PPM_GAP) % (PPM_LED + PPM_GAP);
+            uint8_t rgb[3] = { 0, 0, 0 };
+            if(px >= PPM_GAP && py >= PPM_GAP && xo < PPM_LED && yo < PPM_LED) {
+                if(img[x] & (1 << y)) {
+                    rgb[0] = 255; rgb[1] = 40;
+                } else {
+                    rgb[0] = 40; rgb[1] = 8;
+                }
+            }
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    fclose(f);
+}
+
+/*
+ * Expected images, straight from the drawing calls' definitions
+ * (image: bit 0 = top row; drawing: y 0 = bottom)
+ */
+
+static void expectBars(uint32_t *img, const uint8_t *heights)
+{
+    for(int x = 0; x < SD_BARS; x++) {
+        img[x] = 0;
+        for(int y = 0; y < heights[x]; y++) img[x] |= 1 << (SD_ROWS - 1 - y);
+    }
+}
+
+static void expectRows(uint32_t *img, const uint16_t *rows)
+{
+    for(int x = 0; x < SD_BARS; x++) {
+        img[x] = 0;
+        for(int y = 0; y < SD_ROWS; y++) {
+            if(rows[y] & (1 << x)) img[x] |= 1 << y;
+        }
+    }
+}
+
+/*
+ * Scenes
+ */
+
+static const char *sceneNames[] = { "blank", "bars", "dots", "letter", "rows", "lamp" };
+#define NUM_SCENES (int)(sizeof(sceneNames) / sizeof(sceneNames[0]))
+
+// Draw scene; fills in expected image, returns false if there is none
+static bool drawScene(int s, uint32_t *want)
+{
+    uint8_t heights[SD_BARS];
+    uint16_t rows[SD_ROWS];
+
+    disp.clearBuf();
+
+    switch(s) {
+    case 0:
+        disp.show();
+        memset(want, 0, sizeof(uint32_t) * SD_BARS);
+        return true;
+    case 1:
+        for(int x = 0; x < SD_BARS; x++) {
+            heights[x] = (x + 1) * SD_ROWS / SD_BARS;
+            disp.drawBarWithHeight(x, heights[x]);
+        }
+        disp.show();
+        expectBars(want, heights);
+        return true;
+    case 2:
+        for(int x = 0; x < SD_BARS; x++) {
+            disp.drawDot(x, x * 2 + 1);
+            want[x] = 1 << (SD_ROWS - 1 - (x * 2 + 1));
+        }
+        disp.show();
+        return true;
+    case 3:
+        disp.drawLetterAndShow('A');
+        return false;
+    case 4:
+        for(int y = 0; y < SD_ROWS; y++) {
+            rows[y] = (y & 1) ? 0x5555 : (0xaaaa ^ (1 << (y % SD_BARS)));
+        }
+        disp.drawFieldRows(rows);
+        disp.show();
+        expectRows(want, rows);
+        return true;
+    case 5:
+        disp.lampTest();
+        for(int x = 0; x < SD_BARS; x++) want[x] = SD_COL_MASK;
+        return true;
+    }
+
+    return false;
+}
+
+static void benchShow()
+{
+    uint8_t heights[SD_BARS];
+    uint32_t trans;
+    double t, busUs;
+
+    for(int x = 0; x < SD_BARS; x++) {
+        heights[x] = (x * 7) % (SD_ROWS + 1);
+        disp.drawBarWithHeight(x, heights[x]);
+    }
+
+    Wire.resetStats();
+    t = seconds();
+    for(int i = 0; i < SHOW_RUNS; i++) {
+        disp.show();
+    }
+    t = seconds() - t;
+    busUs = Wire.getBusUs();
+    trans = Wire.getTransactions();
+
+    printf("show(), %d chips: %.2f us host CPU (incl. model); modelled bus %.0f us (%.1f trans, %.0f bytes)\n",
+        SD_NUM_CHIPS, t * 1e6 / SHOW_RUNS, busUs / SHOW_RUNS,
+        (double)trans / SHOW_RUNS, (double)Wire.getBytes() / SHOW_RUNS);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t img[SD_BARS], want[SD_BARS];
+    uint32_t frames[NUM_SCENES][SD_BARS];
+    bool update = false;
+    const char *goldenFn, *ppmDir = NULL;
+    int a = 1;
+
+    if(a < argc && !strcmp(argv[a], "-u")) {
+        update = true;
+        a++;
+    }
+    if(a >= argc) {
+        printf("usage: %s [-u] golden.txt [ppmdir]\n", argv[0]);
+        return 2;
+    }
+    goldenFn = argv[a++];
+    if(a < argc) ppmDir = argv[a];
+
+    if(!update && loadGolden(goldenFn) < 0) {
+        printf("%s: cannot open\n", goldenFn);
+        return 1;
+    }
+
+    shim_setMicros(1000);
+    Wire.begin(-1, -1, 400000);
+    disp.begin();
+
+    for(int s = 0; s < NUM_SCENES; s++) {
+        bool check = drawScene(s, want);
+        
+        vWire.getImage(img);
+        memcpy(frames[s], img, sizeof(img));
+
+        if(check && memcmp(img, want, sizeof(img))) {
+            printf("%s: image differs from drawing (expected, got: + lit, - dark)\n", sceneNames[s]);
+            printDiff(want, img);
+            errors++;
+        }
+
+        if(!update) {
+            int g;
+            for(g = 0; g < numGolden; g++) {
+                if(!strcmp(golden[g].name, sceneNames[s])) break;
+            }
+            if(g == numGolden) {
+                printf("%s: not in %s\n", sceneNames[s], goldenFn);
+                errors++;
+            } else if(memcmp(img, golden[g].img, sizeof(img))) {
+                printf("%s: frame differs from %s (expected, got: + lit, - dark)\n", sceneNames[s], goldenFn);
+                printDiff(golden[g].img, img);
+                errors++;
+            }
+        }
+
+        if(ppmDir) writePPM(ppmDir, sceneNames[s], img);
+    }
+
+    if(update) {
+        FILE *f = fopen(goldenFn, "w");
+        if(!f) {
+            printf("%s: cannot write\n", goldenFn);
+            return 1;
+        }
+        for(int s = 0; s < NUM_SCENES; s++) {
+            fprintf(f, "# %s\n", sceneNames[s]);
+            printFrame(frames[s], f);
+        }
+        fclose(f);
+        printf("%s: %d frames written\n", goldenFn, NUM_SCENES);
+    }
+
+    benchShow();
+
+    // Let the virtual display print its statistics
+    shim_advance(10000000);
+    disp.show();
+
+    if(errors) {
+        printf("FAILED: %d errors\n", errors);
+        return 1;
+    }
+    
+    printf("OK\n");
+    
+    return 0;
+}
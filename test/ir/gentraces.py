@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+#
+# Generate IR traces for the host tests, in the format of the
+# SID_IR_DUMP output:
+#   IR <len> <hash> <protocol> <address> <command> <repeat>: <durations>
+# Durations are in us, starting with the gap before the transmission;
+# odd entries are marks. A label after '#' names the key. The fields before the colon are what the
+# firmware is expected to report; they are computed here from the 
+# encoded values, independently of the firmware's decoders.
+#
+# Timing is modelled after a typical IR receiver module: marks are
+# stretched and spaces shortened by RX_SKEW us, plus gaussian jitter.
+# Traces captured from real remotes (SID_IR_DUMP) can be added to
+# traces/ as they are.
+#
+# Usage: gentraces.py <outdir>
+
+import os
+import random
+import sys
+
+RX_SKEW   = 50
+RX_JITTER = 20
+
+PROTO_UNKNOWN, PROTO_NEC, PROTO_SIRC, PROTO_RC5, PROTO_RC6 = range(5)
+
+FNV_PRIME_32 = 16777619
+FNV_BASIS_32 = 2166136261
+
+REPEAT_WIN = 200000
+
+def compare(a, b):
+    if b < a * 80 // 100: return 0
+    if a < b * 80 // 100: return 2
+    return 1
+
+def timing_hash(d):
+    h = FNV_BASIS_32
+    for i in range(1, len(d) - 2):
+        h = ((h * FNV_PRIME_32) & 0xffffffff) ^ compare(d[i], d[i + 2])
+    return h
+
+def code_hash(proto, addr, cmd):
+    h = FNV_BASIS_32
+    for b in (proto, addr & 0xff, addr >> 8, cmd & 0xff, cmd >> 8):
+        h = ((h * FNV_PRIME_32) & 0xffffffff) ^ b
+    return h
+
+# Nominal marks/spaces (first = mark) -> received durations
+def receive(rng, nominal):
+    out = []
+    for i, d in enumerate(nominal):
+        skew = -RX_SKEW if (i & 1) else RX_SKEW
+        out.append(max(1, int(round(d + skew + rng.gauss(0, RX_JITTER)))))
+    return out
+
+# Half-bit slots (1 = mark) -> durations, starting with a mark
+def slots_to_durations(slots, unit):
+    while slots and not slots[0]: slots = slots[1:]
+    while slots and not slots[-1]: slots = slots[:-1]
+    d, cur, n = [], 1, 0
+    for s in slots:
+        if s == cur:
+            n += 1
+        else:
+            d.append(n * unit)
+            cur, n = s, 1
+    d.append(n * unit)
+    return d
+
+def nec(addr, cmd):
+    if addr < 0x100:
+        addr |= (addr ^ 0xff) << 8
+    val = addr | (cmd << 16) | ((cmd ^ 0xff) << 24)
+    d = [9000, 4500]
+    for i in range(32):
+        d += [560, 1690 if (val >> i) & 1 else 560]
+    return d + [560]
+
+def nec_repeat():
+    return [9000, 2250, 560]
+
+def sirc(bits, addr, cmd):
+    val = cmd | (addr << 7)
+    d = [2400, 600]
+    for i in range(bits):
+        d += [1200 if (val >> i) & 1 else 600, 600]
+    return d[:-1]
+
+def rc5(toggle, addr, cmd):
+    val = (1 << 13) | ((0 if cmd & 0x40 else 1) << 12) | (toggle << 11) | \
+          ((addr & 0x1f) << 6) | (cmd & 0x3f)
+    slots = []
+    for i in range(13, -1, -1):
+        slots += [0, 1] if (val >> i) & 1 else [1, 0]
+    return slots_to_durations(slots, 889)
+
+def rc6(mode, toggle, addr, cmd):
+    bits = [1] + [(mode >> i) & 1 for i in (2, 1, 0)]
+    slots = [1] * 6 + [0] * 2
+    for b in bits:
+        slots += [1, 0] if b else [0, 1]
+    slots += [1, 1, 0, 0] if toggle else [0, 0, 1, 1]
+    dbits = 16 if mode == 0 else 32
+    val = (addr << (dbits // 2)) | cmd
+    for i in range(dbits - 1, -1, -1):
+        slots += [1, 0] if (val >> i) & 1 else [0, 1]
+    return slots_to_durations(slots, 444)
+
+# Frames of unknown protocols: Samsung32, Kaseikyo (Panasonic) 48 bit
+def samsung(addr, cmd):
+    val = addr | (addr << 8) | (cmd << 16) | ((cmd ^ 0xff) << 24)
+    d = [4500, 4500]
+    for i in range(32):
+        d += [560, 1690 if (val >> i) & 1 else 560]
+    return d + [560]
+
+def kaseikyo(data):
+    d = [3456, 1728]
+    for i in range(48):
+        d += [432, 1296 if (data >> i) & 1 else 432]
+    return d + [432]
+
+class Trace:
+
+    def __init__(self, seed):
+        self.rng = random.Random(seed)
+        self.lines = []
+        self.prev = None            # (proto, addr, cmd, toggle, hash)
+        self.prev_start = -10**9
+        self.t = 0                  # start of current frame
+        self.end = 0                # end of previous frame
+
+    # Frame starting "period" us after start of previous one, or
+    # (if pause) "pause" us after its end
+    def frame(self, nominal, proto, addr=0, cmd=0, toggle=0, nec_rep=False,
+              period=None, pause=None, label=None):
+        if period is not None:
+            start = self.t + period
+        else:
+            start = self.end + pause
+        gap = start - self.end
+        d = receive(self.rng, nominal)
+        d = [gap] + d
+        recent = (start - self.prev_start) < REPEAT_WIN
+        repeat = 0
+        if nec_rep:
+            if not (recent and self.prev and self.prev[0] == PROTO_NEC):
+                h, proto, addr, cmd = 0, PROTO_NEC, 0, 0
+                valid = False
+            else:
+                proto, addr, cmd, h = self.prev[0], self.prev[1], self.prev[2], self.prev[4]
+                repeat, valid = 1, True
+        else:
+            if proto in (PROTO_RC5, PROTO_RC6):
+                h = code_hash(proto, addr, cmd)
+            else:
+                h = timing_hash(d)
+            if (recent and proto != PROTO_NEC and self.prev and
+                self.prev[:4] == (proto, addr, cmd, toggle)):
+                repeat = 1
+            valid = True
+        if label is None:
+            label = "%s %x/%x" % (("?", "nec", "sirc", "rc5", "rc6")[proto], addr, cmd)
+        self.lines.append("IR %d %08x %d %x %x %d: %s  # %s" % (
+            len(d), h if valid else 0, proto, addr, cmd, repeat, 
+            " ".join(str(x) for x in d), label))
+        if valid and not nec_rep:
+            self.prev = (proto, addr, cmd, toggle, h)
+        self.prev_start = start
+        self.t = start
+        self.end = start + sum(d[1:])
+
+    def write(self, fn, comment):
+        with open(fn, "w") as f:
+            f.write("# %s\n# Generated by gentraces.py\n" % comment)
+            for l in self.lines:
+                f.write(l + "\n")
+
+# Keys of the built-in remote: NEC address 0x00
+BUILTIN = [ 0x19, 0x45, 0x46, 0x47, 0x44, 0x40, 0x43, 0x07, 0x15, 0x09,
+            0x16, 0x0d, 0x18, 0x52, 0x08, 0x5a, 0x1c ]
+
+def main(outdir):
+    tr = Trace(1)
+    for c in BUILTIN:
+        tr.frame(nec(0x00, c), PROTO_NEC, 0x00, c, pause=500000)
+    # Hold "arrow down"
+    tr.frame(nec(0x00, 0x52), PROTO_NEC, 0x00, 0x52, pause=500000)
+    for i in range(3):
+        tr.frame(nec_repeat(), PROTO_NEC, nec_rep=True, period=108000)
+    tr.write(os.path.join(outdir, "builtin.txt"), 
+             "Built-in remote (NEC, address 0x00): keys 0-9 * # up down left right OK, then down held")
+
+    tr = Trace(2)
+    for a, c in ((0x04, 0x08), (0x04, 0x02), (0x20, 0x10), (0x20, 0x11)):
+        tr.frame(nec(a, c), PROTO_NEC, a, c, pause=400000)
+    for a, c in ((0x1234, 0x01), (0x5e21, 0x45), (0x3d2c, 0x0c)):
+        tr.frame(nec(a, c), PROTO_NEC, a, c, pause=400000)
+        tr.frame(nec_repeat(), PROTO_NEC, nec_rep=True, period=108000)
+    # Repeat frame after a pause: not a repeat of anything
+    tr.frame(nec_repeat(), PROTO_NEC, nec_rep=True, pause=600000)
+    tr.write(os.path.join(outdir, "nec.txt"), 
+             "NEC: standard and extended addresses, repeat frames")
+
+    tr = Trace(3)
+    for bits, a, c in ((12, 1, 0x12), (12, 1, 0x13), (12, 1, 0x74), (15, 0x97, 0x21),
+                       (15, 0x1a, 0x45), (20, 0x1a3a, 0x3c), (20, 0x0b1, 0x07)):
+        tr.frame(sirc(bits, a, c), PROTO_SIRC, a, c, pause=400000)
+        for i in range(2):
+            tr.frame(sirc(bits, a, c), PROTO_SIRC, a, c, period=45000)
+    tr.write(os.path.join(outdir, "sirc.txt"), 
+             "Sony SIRC 12, 15 and 20 bit; every key sent three times")
+
+    tr = Trace(4)
+    toggle = 0
+    for a, c in ((0, 0x0c), (0, 0x10), (0, 0x11), (5, 0x35), (0, 0x50), (0x1f, 0x7f), (0, 0x00)):
+        tr.frame(rc5(toggle, a, c), PROTO_RC5, a, c, toggle, pause=400000)
+        for i in range(2):
+            tr.frame(rc5(toggle, a, c), PROTO_RC5, a, c, toggle, period=113778)
+        toggle ^= 1
+    # Same key pressed again quickly: toggle differs, no repeat
+    tr.frame(rc5(toggle, 0, 0x00), PROTO_RC5, 0, 0x00, toggle, period=113778)
+    tr.write(os.path.join(outdir, "rc5.txt"), 
+             "RC5 incl. field bit (commands >= 0x40); held keys, toggle bit")
+
+    tr = Trace(5)
+    toggle = 0
+    for a, c in ((0x00, 0x0c), (0x00, 0x10), (0x04, 0x5b), (0xff, 0xff)):
+        tr.frame(rc6(0, toggle, a, c), PROTO_RC6, a, c, toggle, pause=400000)
+        tr.frame(rc6(0, toggle, a, c), PROTO_RC6, a, c, toggle, period=106667)
+        toggle ^= 1
+    # MCE (mode 6A): toggle in command bit 15
+    for c in (0x040d, 0x041e, 0x0422):
+        tr.frame(rc6(6, 0, 0x800f, c), PROTO_RC6, 0x800f, c, 0, pause=400000)
+        tr.frame(rc6(6, 0, 0x800f, c), PROTO_RC6, 0x800f, c, 0, period=106667)
+        tr.frame(rc6(6, 0, 0x800f, c | 0x8000), PROTO_RC6, 0x800f, c, 2, pause=300000)
+    tr.write(os.path.join(outdir, "rc6.txt"), 
+             "RC6 mode 0 and mode 6 (MCE, toggle in bit 15)")
+
+    tr = Trace(6)
+    for a, c in ((0x07, 0x02), (0x07, 0x07), (0x07, 0x0b), (0x07, 0x60), (0x07, 0x61)):
+        tr.frame(samsung(a, c), PROTO_UNKNOWN, pause=400000, label="samsung %x/%x" % (a, c))
+    for data in (0x0100bcbd2002, 0x01009c9d2002, 0x0100a0a12002, 0x0100a1a02002):
+        tr.frame(kaseikyo(data), PROTO_UNKNOWN, pause=400000, label="kaseikyo %012x" % data)
+    tr.write(os.path.join(outdir, "unknown.txt"), 
+             "Protocols not decoded (hash only): Samsung32, Kaseikyo 48 bit")
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), "traces"))
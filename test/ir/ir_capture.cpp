@@ -0,0 +1,269 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host tests: IR capture against 50us sampling
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+
+#include "shim.h"
+#include "input.h"
+#include "irtrace.h"
+
+/*
+ * The receiver used to sample the IR pin every 50us from a timer 
+ * interrupt and count durations in ticks; now edges are timestamped 
+ * by a pin interrupt, and the end of a transmission is detected in 
+ * loop(). This replays the traces through both: oldCapture() is 
+ * the former timer ISR's state machine, run on the same edges at 
+ * every sampling phase (1us steps). For every frame, the buffers 
+ * must have the same layout (same length, each duration within one
+ * tick), and the new capture must give the timing hash of one of 
+ * the phases - of all of them, if sampling does not depend on the
+ * phase. The only exception are frames where two compared durations
+ * are within one tick of the hash's 80% threshold: There, sampling
+ * may round to the other side at every phase. Those frames as well
+ * as those with phase-dependent hashes are counted. The built-in 
+ * remote's codes must match the table in sid_main.cpp, also when 
+ * loop() is late and the end of a transmission is only noticed by 
+ * the ISR when the next one starts.
+ */
+
+#define TICK_US    50
+#define GAP_TICKS  (5000 / TICK_US)
+#define PHASES     TICK_US
+
+// remote_codes[][2] in sid_main.cpp: keys 0-9 * # up down left right OK
+static const uint32_t builtinCodes[17] = {
+    0x97483bfb, 0xe318261b, 0x00511dbb, 0xee886d7f, 0x52a3d41f, 0xd7e84b1b,
+    0x20fe4dbb, 0xf076c13b, 0xa3c8eddb, 0xe5cfbd7f, 0xc101e57b, 0xf0c41643,
+    0x3d9ae3f7, 0x1bc0157b, 0x8c22657b, 0x0449e79f, 0x488f3cbb
+};
+
+static IRTrace  traces[IR_MAX_TRACES];
+static IRRemote ir(IR_TEST_PIN);
+
+static int fails = 0;
+static int phaseDeps = 0;
+static int marginal = 0;
+
+#define CHECK(cond, ...) do { if(!(cond)) { printf(__VA_ARGS__); printf("\n"); fails++; } } while(0)
+
+/*
+ * Former capture: Timer ISR every TICK_US. The last edge before the
+ * transmission (at 0) was seen by the sample at "phase", which reset
+ * the counter. Returns the number of recorded durations (in ticks), 
+ * 0 if nothing was recorded.
+ */
+static uint32_t oldCapture(const uint32_t *dur, uint32_t len, uint32_t phase, uint32_t *buf)
+{
+    enum { IDLE, LIGHT, DARK, STOP } state = IDLE;
+    unsigned long edge = 0, end = 0;
+    uint32_t cnt = 0, irlen = 0, k = 0;
+
+    for(uint32_t i = 0; i < len; i++) end += dur[i];
+    
+    for(unsigned long t = phase + TICK_US; state != STOP && t < end + 2 * GAP_TICKS * TICK_US; t += TICK_US) {
+        int irpin;
+        // Pin level at t: 0 (light) after even edges
+        while(k < len && edge + dur[k] <= t) edge += dur[k++];
+        irpin = (k & 1) ? 0 : 1;
+
+        cnt++;
+        
+        switch(state) {
+        case IDLE:
+            if(irpin == 0) {
+                if(cnt >= GAP_TICKS) {
+                    state = LIGHT;
+                    buf[0] = cnt;
+                    irlen = 1;
+                }
+                cnt = 0;
+            }
+            break;
+        case LIGHT:
+            if(irpin == 1) {
+                state = DARK;
+                buf[irlen++] = cnt;
+                cnt = 0;
+                if(irlen >= IRBUFSIZE) state = STOP;
+            }
+            break;
+        case DARK:
+            if(irpin == 0) {
+                state = LIGHT;
+                buf[irlen++] = cnt;
+                cnt = 0;
+                if(irlen >= IRBUFSIZE) state = STOP;
+            } else if(cnt > GAP_TICKS) {
+                state = STOP;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return (state == STOP) ? irlen : 0;
+}
+
+// True if two compared durations are within one tick of the
+// threshold in IRRemote::compare()
+static bool nearThreshold(const uint32_t *buf, uint32_t len)
+{
+    for(uint32_t i = 1; i + 2 < len; i++) {
+        long a = buf[i], b = buf[i+2];
+        if(labs(a - b * 80 / 100) < TICK_US || labs(b - a * 80 / 100) < TICK_US)
+            return true;
+    }
+    
+    return false;
+}
+
+static void checkFrame(const IRTrace *t)
+{
+    uint32_t old[IRBUFSIZE], oldHash[PHASES] = { 0 };
+    uint32_t len, nhash;
+    const uint32_t *nbuf;
+    bool phaseDep = false, match = false;
+    
+    ir_replay(ir, t->dur, t->len);
+    nbuf = ir.readDurations(len);
+
+    CHECK(len == t->len, "%s:%d: captured %u durations, expected %u", t->file, t->line, len, t->len);
+    if(len != t->len)
+        return;
+
+    nhash = IRRemote::hashDurations(nbuf, len);
+
+    for(int p = 0; p < PHASES; p++) {
+        uint32_t olen = oldCapture(t->dur, t->len, p, old);
+        CHECK(olen == len, "%s:%d: phase %d: sampled %u durations, edges %u", 
+            t->file, t->line, p, olen, len);
+        if(olen != len)
+            return;
+        for(uint32_t i = 0; i < len; i++) {
+            long diff = (long)nbuf[i] - (long)(old[i] * TICK_US);
+            CHECK(nbuf[i] == t->dur[i], "%s:%d: duration %u: %u, sent %u", 
+                t->file, t->line, i, nbuf[i], t->dur[i]);
+            CHECK(diff > -TICK_US && diff < TICK_US, "%s:%d: phase %d: duration %u: %uus, sampled %u ticks",
+                t->file, t->line, p, i, nbuf[i], old[i]);
+        }
+        if(len >= 6) {
+            oldHash[p] = IRRemote::hashDurations(old, len);
+            if(oldHash[p] != oldHash[0]) phaseDep = true;
+            if(oldHash[p] == nhash) match = true;
+        }
+    }
+
+    if(len >= 6) {
+        if(phaseDep) phaseDeps++;
+        if(!match && nearThreshold(nbuf, len)) {
+            marginal++;
+        } else {
+            CHECK(match, "%s:%d: hash %08x, sampled %08x", t->file, t->line, nhash, oldHash[0]);
+        }
+    }
+}
+
+// Built-in remote: Every key must give its code from the table
+static void checkBuiltin(const char *fn)
+{
+    static IRTrace bt[IR_MAX_TRACES];
+    int n = ir_loadTraces(fn, bt, IR_MAX_TRACES), found = 0;
+
+    for(int k = 0; k < 17; k++) {
+        bool hit = false;
+        for(int i = 0; i < n && !hit; i++) {
+            if(bt[i].len < 6) continue;
+            if(ir_replay(ir, bt[i].dur, bt[i].len) && ir.readHash() == builtinCodes[k]) {
+                hit = true;
+            }
+        }
+        CHECK(hit, "%s: built-in key %d (%08x) not received", fn, k, builtinCodes[k]);
+        if(hit) found++;
+    }
+
+    printf("Built-in remote: %d of 17 keys\n", found);
+}
+
+// Transmissions back to back, loop() called after the last one
+static void checkLate(const char *fn)
+{
+    static IRTrace bt[IR_MAX_TRACES];
+    int n = ir_loadTraces(fn, bt, IR_MAX_TRACES), got = 0;
+    const int batch = 4;
+
+    for(int i = 0; i + batch <= n; i += batch) {
+        for(int j = 0; j < batch; j++) {
+            ir_feed(bt[i + j].dur, bt[i + j].len);
+        }
+        shim_advance(10000);
+        for(int j = 0; j < batch; j++) {
+            bool ok = ir.loop();
+            CHECK(ok && ir.readHash() == bt[i + j].hash, "%s:%d: late loop(): %08x, expected %08x",
+                fn, bt[i + j].line, ok ? ir.readHash() : 0, bt[i + j].hash);
+            if(ok) got++;
+        }
+    }
+
+    printf("Late loop(): %d frames received\n", got);
+}
+
+int main(int argc, const char **argv)
+{
+    int n = 0;
+
+    if(argc < 2) {
+        printf("Usage: %s <builtin traces> [<trace files>]\n", argv[0]);
+        return 2;
+    }
+
+    for(int i = 1; i < argc; i++) {
+        int r = ir_loadTraces(argv[i], &traces[n], IR_MAX_TRACES - n);
+        if(r < 0) return 2;
+        n += r;
+    }
+
+    ir_begin(ir);
+    
+    for(int i = 0; i < n; i++) {
+        checkFrame(&traces[i]);
+    }
+    printf("Capture: %d frames checked against %dus sampling; %d with phase-dependent hash, "
+           "%d near threshold and different\n", n, TICK_US, phaseDeps, marginal);
+
+    checkBuiltin(argv[1]);
+    checkLate(argv[1]);
+
+    printf("%s\n", fails ? "FAILED" : "OK");
+    
+    return fails ? 1 : 0;
+}
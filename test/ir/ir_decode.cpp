@@ -0,0 +1,198 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host tests: IR protocol decoders
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+
+#include "shim.h"
+#include "input.h"
+#include "irtrace.h"
+
+/*
+ * Replays the traces in order (with their gaps, so that repeat
+ * detection sees the original timing) and checks that every frame
+ * is decoded into the recorded protocol, address, command, repeat 
+ * flag and hash. Frames recorded with hash 0 must be rejected. Every
+ * protocol variant must be covered by the traces. Then some damaged 
+ * frames, which must not be decoded as their protocol.
+ */
+
+static IRTrace  traces[IR_MAX_TRACES];
+static IRRemote ir(IR_TEST_PIN);
+
+static int fails = 0;
+
+#define CHECK(cond, ...) do { if(!(cond)) { printf(__VA_ARGS__); printf("\n"); fails++; } } while(0)
+
+// Decoded frames per protocol variant
+enum { V_NEC, V_NEC_EXT, V_NEC_REP, V_SIRC12, V_SIRC15, V_SIRC20, V_RC5, V_RC5_FIELD,
+       V_RC5_REP, V_RC6_0, V_RC6_6, V_RC6_REP, V_UNKNOWN, V_REJECTED, V_NUM };
+static const char *vNames[V_NUM] = {
+    "NEC", "NEC extended", "NEC repeat", "SIRC-12", "SIRC-15", "SIRC-20", "RC5",
+    "RC5 field bit", "RC5 repeat", "RC6 mode 0", "RC6 mode 6", "RC6 repeat", 
+    "unknown", "rejected"
+};
+static int vCount[V_NUM];
+
+static void count(const IRTrace *t, bool ok)
+{
+    const IRCode &c = ir.readCode();
+
+    if(!ok) {
+        vCount[V_REJECTED]++;
+        return;
+    }
+    
+    switch(c.protocol) {
+    case IRPROTO_NEC:
+        vCount[c.repeat ? V_NEC_REP : (c.address > 0xff ? V_NEC_EXT : V_NEC)]++;
+        break;
+    case IRPROTO_SIRC:
+        vCount[t->len == 26 ? V_SIRC12 : (t->len == 32 ? V_SIRC15 : V_SIRC20)]++;
+        break;
+    case IRPROTO_RC5:
+        vCount[c.repeat ? V_RC5_REP : (c.command >= 0x40 ? V_RC5_FIELD : V_RC5)]++;
+        break;
+    case IRPROTO_RC6:
+        vCount[c.repeat ? V_RC6_REP : (c.address > 0xff ? V_RC6_6 : V_RC6_0)]++;
+        break;
+    default:
+        vCount[V_UNKNOWN]++;
+    }
+}
+
+static void checkTraces(int n)
+{
+    for(int i = 0; i < n; i++) {
+        const IRTrace *t = &traces[i];
+        bool ok = ir_replay(ir, t->dur, t->len);
+        const IRCode &c = ir.readCode();
+
+        count(t, ok);
+        
+        if(!t->hash) {
+            CHECK(!ok, "%s:%d: accepted, expected rejected", t->file, t->line);
+            continue;
+        }
+
+        CHECK(ok, "%s:%d: rejected", t->file, t->line);
+        if(!ok)
+            continue;
+
+        CHECK(c.protocol == t->protocol && c.address == t->address && 
+              c.command == t->command && c.repeat == !!t->repeat && 
+              ir.readHash() == t->hash,
+              "%s:%d: got %d %x/%x rep %d hash %08x, expected %d %x/%x rep %d hash %08x",
+              t->file, t->line, c.protocol, c.address, c.command, c.repeat, ir.readHash(),
+              t->protocol, t->address, t->command, t->repeat, t->hash);
+    }
+}
+
+// Replay a damaged copy of a frame after a pause (no repeat)
+static void checkDamaged(const IRTrace *t, const char *what, int idx, int32_t delta, int cut = 0)
+{
+    uint32_t d[IRBUFSIZE];
+    uint32_t len = t->len - cut;
+    bool ok;
+
+    memcpy(d, t->dur, sizeof(d));
+    d[0] = 1000000;
+    d[idx] += delta;
+    ok = ir_replay(ir, d, len);
+
+    CHECK(!ok || ir.readCode().protocol != t->protocol, 
+        "%s:%d: %s: still decoded as protocol %d", t->file, t->line, what, t->protocol);
+}
+
+static const IRTrace *findProto(int n, int proto, uint32_t len)
+{
+    for(int i = 0; i < n; i++) {
+        if(traces[i].protocol == proto && traces[i].len == len && !traces[i].repeat)
+            return &traces[i];
+    }
+    
+    return NULL;
+}
+
+static void checkDamagedFrames(int n)
+{
+    const IRTrace *t;
+    
+    if((t = findProto(n, IRPROTO_NEC, 68))) {
+        // Space of a command bit: 0 <-> 1; command no longer matches its inverse
+        checkDamaged(t, "NEC command bit", 2 + 2 * 17, t->dur[2 + 2 * 17] > 1000 ? -1100 : 1100);
+        checkDamaged(t, "NEC leader", 1, -4000);
+        checkDamaged(t, "NEC truncated", 0, 0, 2);
+    }
+    if((t = findProto(n, IRPROTO_SIRC, 26))) {
+        checkDamaged(t, "SIRC header", 1, -1200);
+        checkDamaged(t, "SIRC truncated", 0, 0, 2);
+    }
+    if((t = findProto(n, IRPROTO_RC5, 24))) {
+        checkDamaged(t, "RC5 long mark", 3, 2000);
+    }
+    if((t = findProto(n, IRPROTO_RC6, 36))) {
+        checkDamaged(t, "RC6 leader", 1, -1500);
+        checkDamaged(t, "RC6 long space", 4, 1500);
+    }
+}
+
+int main(int argc, const char **argv)
+{
+    int n = 0;
+
+    if(argc < 2) {
+        printf("Usage: %s <trace files>\n", argv[0]);
+        return 2;
+    }
+
+    for(int i = 1; i < argc; i++) {
+        int r = ir_loadTraces(argv[i], &traces[n], IR_MAX_TRACES - n);
+        if(r < 0) return 2;
+        n += r;
+    }
+
+    ir_begin(ir);
+    
+    checkTraces(n);
+
+    printf("Decoded:");
+    for(int v = 0; v < V_NUM; v++) {
+        printf(" %s %d%s", vNames[v], vCount[v], v < V_NUM - 1 ? "," : "\n");
+        CHECK(vCount[v], "No frames of %s", vNames[v]);
+    }
+
+    checkDamagedFrames(n);
+
+    printf("%s\n", fails ? "FAILED" : "OK");
+    
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host tests: IR hash throughput, collisions, jitter
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+
+#include "shim.h"
+#include "input.h"
+#include "irtrace.h"
+
+/*
+ * Replays all traces given on the command line through the receiver
+ * and decoders (IRRemote, as on the device) and reports
+ * - calcHash() throughput (timing hash over the recorded durations),
+ * - collisions: different keys with the same hash (readHash(), the 
+ *   key for the IR code tables), in the corpus and for all standard 
+ *   NEC codes,
+ * - jitter tolerance: For each jitter level (every duration deviating
+ *   by a random amount of up to +/- n%), how many of JITTER_TRIALS 
+ *   replays per frame still result in the same hash; for the timing
+ *   hash alone, and for readHash().
+ * Fails on collisions in the corpus.
+ */
+
+#define HASH_RUNS     20000
+#define JITTER_TRIALS 50
+#define MAX_FILES     16
+
+static IRTrace  traces[IR_MAX_TRACES];
+static uint32_t hashes[IR_MAX_TRACES];
+static bool     valid[IR_MAX_TRACES];
+
+static IRRemote ir(IR_TEST_PIN);
+
+static void keyName(const IRTrace *t, char *buf, int len)
+{
+    const IRCode &c = ir.readCode();
+    
+    if(t->label[0]) {
+        snprintf(buf, len, "%s", t->label);
+    } else if(c.protocol != IRPROTO_UNKNOWN) {
+        snprintf(buf, len, "%d %x/%x", c.protocol, c.address, c.command);
+    } else {
+        snprintf(buf, len, "%s:%d", t->file, t->line);
+    }
+}
+
+static void benchHash(int n)
+{
+    uint32_t sum = 0, cnt = 0, durs = 0;
+    double t;
+
+    t = ir_seconds();
+    for(int r = 0; r < HASH_RUNS; r++) {
+        for(int i = 0; i < n; i++) {
+            if(traces[i].len < 6) continue;
+            sum += IRRemote::hashDurations(traces[i].dur, traces[i].len);
+            cnt++;
+            durs += traces[i].len;
+        }
+    }
+    t = ir_seconds() - t;
+
+    printf("calcHash: %u hashes in %.3fs: %.0f hashes/s, %.1fns per duration (host) [%08x]\n",
+        cnt, t, cnt / t, t * 1e9 / durs, sum);
+}
+
+static int corpusCollisions(int n)
+{
+    static char names[IR_MAX_TRACES][48];
+    int keys = 0, coll = 0;
+
+    ir_begin(ir);
+    for(int i = 0; i < n; i++) {
+        valid[i] = ir_replay(ir, traces[i].dur, traces[i].len);
+        hashes[i] = ir.readHash();
+        keyName(&traces[i], names[i], sizeof(names[i]));
+    }
+    
+    for(int i = 0; i < n; i++) {
+        bool first = true;
+        if(!valid[i]) continue;
+        for(int j = 0; j < i; j++) {
+            if(valid[j] && !strcmp(names[i], names[j])) first = false;
+        }
+        if(!first) continue;
+        keys++;
+        for(int j = 0; j < i; j++) {
+            if(valid[j] && hashes[j] == hashes[i] && strcmp(names[i], names[j])) {
+                printf("Collision: %s (%s:%d) and %s (%s:%d): %08x\n", 
+                    names[i], traces[i].file, traces[i].line,
+                    names[j], traces[j].file, traces[j].line, hashes[i]);
+                coll++;
+                break;
+            }
+        }
+    }
+    
+    printf("Corpus: %d frames, %d keys, %d collisions\n", n, keys, coll);
+    
+    return coll;
+}
+
+// Timing hash of all 65536 standard NEC codes (address, command
+// each followed by its inverse), as received (jittered)
+static void necCollisions()
+{
+    static uint32_t h[65536];
+    uint32_t d[68];
+    int coll = 0;
+
+    d[0] = 100000; d[1] = 9000; d[2] = 4500; d[67] = 560;
+    for(uint32_t code = 0; code < 65536; code++) {
+        uint32_t a = code & 0xff, c = code >> 8;
+        uint32_t val = a | ((a ^ 0xff) << 8) | (c << 16) | ((c ^ 0xff) << 24);
+        for(int i = 0; i < 32; i++) {
+            d[3 + 2*i] = 560 + 50 + ir_rand() % 41 - 20;
+            d[4 + 2*i] = ((val >> i) & 1 ? 1690 : 560) - 50 + ir_rand() % 41 - 20;
+        }
+        h[code] = IRRemote::hashDurations(d, 68);
+    }
+    std::sort(h, h + 65536);
+    for(int i = 1; i < 65536; i++) {
+        if(h[i] == h[i - 1]) coll++;
+    }
+    
+    printf("NEC: 65536 standard codes, %d collisions\n", coll);
+}
+
+static void jitter(int n, const char **files, int nfiles)
+{
+    uint32_t d[IRBUFSIZE];
+
+    printf("Jitter: same hash in %% of %d trials per frame; timing hash / readHash()\n", JITTER_TRIALS);
+    printf("%-12s", "");
+    for(int j = 5; j <= 40; j += 5) printf("      %2d%%", j);
+    printf("\n");
+
+    for(int f = 0; f < nfiles; f++) {
+        const char *name = strrchr(files[f], '/') ? strrchr(files[f], '/') + 1 : files[f];
+        printf("%-12s", name);
+        for(int j = 5; j <= 40; j += 5) {
+            uint32_t tsame = 0, same = 0, total = 0;
+            for(int i = 0; i < n; i++) {
+                uint32_t thash;
+                // Skip frames whose hash depends on the previous one
+                if(traces[i].file != files[f] || !valid[i] || traces[i].len < 6)
+                    continue;
+                thash = IRRemote::hashDurations(traces[i].dur, traces[i].len);
+                for(int k = 0; k < JITTER_TRIALS; k++) {
+                    d[0] = 1000000;
+                    for(uint32_t l = 1; l < traces[i].len; l++) {
+                        uint32_t dev = traces[i].dur[l] * j / 100;
+                        d[l] = traces[i].dur[l] - dev + ir_rand() % (2 * dev + 1);
+                    }
+                    if(IRRemote::hashDurations(d, traces[i].len) == thash) tsame++;
+                    if(ir_replay(ir, d, traces[i].len) && ir.readHash() == hashes[i]) same++;
+                    total++;
+                }
+            }
+            printf("  %3u/%3u", total ? tsame * 100 / total : 0, total ? same * 100 / total : 0);
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, const char **argv)
+{
+    int n = 0, coll;
+
+    if(argc < 2 || argc - 1 > MAX_FILES) {
+        printf("Usage: %s <trace files>\n", argv[0]);
+        return 2;
+    }
+
+    for(int i = 1; i < argc; i++) {
+        int r = ir_loadTraces(argv[i], &traces[n], IR_MAX_TRACES - n);
+        if(r < 0) return 2;
+        n += r;
+    }
+
+    benchHash(n);
+    coll = corpusCollisions(n);
+    necCollisions();
+    jitter(n, &argv[1], argc - 1);
+
+    return coll ? 1 : 0;
+}
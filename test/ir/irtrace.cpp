@@ -0,0 +1,155 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host tests: IR trace loading and replay
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <time.h>
+
+#include "shim.h"
+#include "irtrace.h"
+
+// IR receiver output levels (see input.cpp)
+#define IR_LIGHT  0
+#define IR_DARK   1
+
+#define IR_END_GAP 6000   // us after last edge to let loop() see the end
+
+static unsigned long lastEdge = 0;
+
+int ir_loadTraces(const char *fn, IRTrace *traces, int maxTraces)
+{
+    FILE *f = fopen(fn, "r");
+    char line[1024];
+    int n = 0, lineNo = 0;
+
+    if(!f) {
+        printf("%s: cannot open\n", fn);
+        return -1;
+    }
+
+    while(n < maxTraces && fgets(line, sizeof(line), f)) {
+        IRTrace *t = &traces[n];
+        char *p, *c;
+        int pos;
+
+        lineNo++;
+        if(strncmp(line, "IR ", 3) || !strchr(line, ':'))
+            continue;
+
+        memset(t, 0, sizeof(*t));
+        t->file = fn;
+        t->line = lineNo;
+
+        if((c = strchr(line, '#'))) {
+            *c++ = 0;
+            while(*c == ' ') c++;
+            strncpy(t->label, c, sizeof(t->label) - 1);
+            t->label[strcspn(t->label, "\r\n")] = 0;
+        }
+
+        if(sscanf(line, "IR %u %x %d %x %x %d:%n", &t->len, &t->hash, &t->protocol,
+                  &t->address, &t->command, &t->repeat, &pos) != 6) {
+            printf("%s:%d: bad line\n", fn, lineNo);
+            continue;
+        }
+
+        p = line + pos;
+        for(uint32_t i = 0; i < t->len; i++) {
+            t->dur[i] = strtoul(p, &p, 10);
+        }
+        if(t->len < 2 || t->len > IRBUFSIZE || !t->dur[t->len - 1]) {
+            printf("%s:%d: bad durations\n", fn, lineNo);
+            continue;
+        }
+        
+        n++;
+    }
+
+    fclose(f);
+    
+    return n;
+}
+
+void ir_begin(IRRemote &ir)
+{
+    shim_setMicros(1000);
+    shim_setPin(IR_TEST_PIN, IR_DARK);
+    ir.begin();
+    lastEdge = micros();
+}
+
+/*
+ * Feed a transmission to the receiver ISR as edges: dur[0] is the 
+ * gap since the last edge of the previous transmission, then marks 
+ * and spaces alternate. ir_replay() then lets time pass so that 
+ * loop() notices the end, as it would in the main loop.
+ */
+void ir_feed(const uint32_t *dur, uint32_t len)
+{
+    unsigned long t = lastEdge;
+    
+    for(uint32_t i = 0; i < len; i++) {
+        t += dur[i];
+        shim_setMicros(t);
+        shim_edge(IR_TEST_PIN, (i & 1) ? IR_DARK : IR_LIGHT);
+    }
+    lastEdge = t;
+}
+
+bool ir_replay(IRRemote &ir, const uint32_t *dur, uint32_t len)
+{
+    ir_feed(dur, len);
+
+    shim_setMicros(lastEdge + IR_END_GAP);
+    
+    return ir.loop();
+}
+
+// xorshift32 for jitter
+uint32_t ir_rand()
+{
+    static uint32_t x = 0x2545f491;
+    
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    
+    return x;
+}
+
+double ir_seconds()
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
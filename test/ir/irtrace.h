@@ -0,0 +1,68 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host tests: IR trace loading and replay
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _IRTRACE_H
+#define _IRTRACE_H
+
+#include "input.h"
+
+#define IR_TEST_PIN   27
+#define IR_MAX_TRACES 512
+
+/*
+ * One line of SID_IR_DUMP output:
+ * IR <len> <hash> <protocol> <address> <command> <repeat>: <durations> [# label]
+ * The label is optional; it names the key for the collision count.
+ */
+typedef struct {
+    const char *file;
+    int         line;
+    uint32_t    len;
+    uint32_t    hash;
+    int         protocol;
+    uint32_t    address;
+    uint32_t    command;
+    int         repeat;
+    char        label[32];
+    uint32_t    dur[IRBUFSIZE];
+} IRTrace;
+
+int  ir_loadTraces(const char *fn, IRTrace *traces, int maxTraces);
+
+void ir_begin(IRRemote &ir);
+void ir_feed(const uint32_t *dur, uint32_t len);
+bool ir_replay(IRRemote &ir, const uint32_t *dur, uint32_t len);
+
+uint32_t ir_rand();
+double   ir_seconds();
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: Arduino core
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SHIM_ARDUINO_H
+#define _SHIM_ARDUINO_H
+
+/*
+ * Just enough of the Arduino/ESP32 core to build the firmware's 
+ * modules on the host. Time, pin levels and interrupts are under 
+ * control of the test (see shim.h).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define IRAM_ATTR
+
+#define LOW           0
+#define HIGH          1
+
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+
+#define RISING        0x01
+#define FALLING       0x02
+#define CHANGE        0x03
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int  digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*isr)(void *), void *arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+uint32_t esp_random();
+void     esp_restart();
+
+#define F(s) (s)
+
+// Critical sections: Single threaded on the host
+typedef struct { int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED  { 0 }
+#define portENTER_CRITICAL(mux)      ((void)(mux))
+#define portEXIT_CRITICAL(mux)       ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)  ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)   ((void)(mux))
+
+int xPortGetCoreID();
+
+// Tasks and timers: There are no threads on the host, task creation
+// fails and timers never fire
+typedef void *TaskHandle_t;
+typedef int BaseType_t;
+#define pdFALSE         0
+#define pdTRUE          1
+#define pdPASS          1
+#define pdFAIL          0
+#define portMAX_DELAY   0xffffffffUL
+#define portYIELD_FROM_ISR()
+#define pdMS_TO_TICKS(ms)  (ms)
+
+BaseType_t xTaskCreatePinnedToCore(void (*func)(void *), const char *name, uint32_t stack,
+                                   void *arg, int prio, TaskHandle_t *handle, int core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, uint32_t ticks);
+
+typedef struct { int num; } hw_timer_t;
+hw_timer_t *timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerAttachInterrupt(hw_timer_t *timer, void (*isr)(void), bool edge);
+void timerAlarmWrite(hw_timer_t *timer, uint64_t value, bool reload);
+void timerAlarmEnable(hw_timer_t *timer);
+void timerAlarmDisable(hw_timer_t *timer);
+
+class Print {
+    public:
+        size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+        size_t print(const char *s);
+        size_t println(const char *s = "");
+};
+
+class HardwareSerial : public Print {
+    public:
+        void begin(unsigned long baud) {}
+};
+
+extern HardwareSerial Serial;
+
+#endif
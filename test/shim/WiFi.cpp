@@ -0,0 +1,112 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: WiFi and UDP
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include "shim.h"
+
+#define SHIM_UDP_QUEUE  8
+
+WiFiClass WiFi;
+
+static struct {
+    uint8_t data[SHIM_UDP_MAX];
+    int     len;
+} udpQueue[SHIM_UDP_QUEUE];
+static int udpHead = 0, udpTail = 0;
+static int udpCur = -1, udpPos = 0;
+
+static uint32_t udpSent = 0;
+
+void shim_udpReceive(const uint8_t *data, int len)
+{
+    int next = (udpHead + 1) % SHIM_UDP_QUEUE;
+
+    if(next == udpTail || len > SHIM_UDP_MAX)
+        return;
+
+    memcpy(udpQueue[udpHead].data, data, len);
+    udpQueue[udpHead].len = len;
+    udpHead = next;
+}
+
+uint32_t shim_udpSent()
+{
+    return udpSent;
+}
+
+bool IPAddress::fromString(const char *s)
+{
+    unsigned int a, b, c, d;
+    
+    if(sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+        return false;
+    _a[0] = a; _a[1] = b; _a[2] = c; _a[3] = d;
+    
+    return true;
+}
+
+int UDP::parsePacket()
+{
+    if(udpCur >= 0) {
+        udpTail = (udpTail + 1) % SHIM_UDP_QUEUE;
+        udpCur = -1;
+    }
+    if(udpTail == udpHead)
+        return 0;
+
+    udpCur = udpTail;
+    udpPos = 0;
+    
+    return udpQueue[udpCur].len;
+}
+
+int UDP::read(uint8_t *buf, size_t len)
+{
+    int n;
+    
+    if(udpCur < 0)
+        return 0;
+
+    n = min((int)len, udpQueue[udpCur].len - udpPos);
+    memcpy(buf, udpQueue[udpCur].data + udpPos, n);
+    udpPos += n;
+    
+    return n;
+}
+
+int UDP::endPacket()
+{
+    udpSent++;
+    return 1;
+}
@@ -0,0 +1,82 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: WiFi and UDP
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SHIM_WIFI_H
+#define _SHIM_WIFI_H
+
+#include <Arduino.h>
+
+/*
+ * WiFi is always connected. UDP packets are not sent anywhere, but
+ * counted; the tests queue incoming packets with shim_udpReceive()
+ * (shim.h), which parsePacket()/read() hand out one by one.
+ */
+
+#define WL_CONNECTED     3
+#define WL_DISCONNECTED  6
+
+#define SHIM_UDP_MAX     512
+
+class IPAddress {
+    public:
+        IPAddress() {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { _a[0] = a; _a[1] = b; _a[2] = c; _a[3] = d; }
+        bool fromString(const char *s);
+        uint8_t operator[](int i) const { return _a[i & 3]; }
+        operator uint32_t() const { return _a[0] | (_a[1] << 8) | (_a[2] << 16) | ((uint32_t)_a[3] << 24); }
+    private:
+        uint8_t _a[4] = { 0, 0, 0, 0 };
+};
+
+class UDP {
+    public:
+        uint8_t   begin(uint16_t port) { return 1; }
+        int       parsePacket();
+        int       read(uint8_t *buf, size_t len);
+        IPAddress remoteIP() { return IPAddress(192, 168, 4, 1); }
+        int       beginPacket(IPAddress ip, uint16_t port) { return 1; }
+        int       beginPacket(const char *host, uint16_t port) { return 1; }
+        size_t    write(const uint8_t *buf, size_t len) { return len; }
+        int       endPacket();
+};
+
+class WiFiUDP : public UDP {
+};
+
+class WiFiClass {
+    public:
+        int status() { return WL_CONNECTED; }
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: i2c bus model
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define WIRE_START_STOP_CLOCKS  2
+#define WIRE_BYTE_CLOCKS        9
+
+TwoWire Wire;
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency)
+{
+    _clock = frequency;
+    return true;
+}
+
+void TwoWire::setClock(uint32_t frequency)
+{
+    _clock = frequency;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _addr = address;
+    _len = 0;
+}
+
+size_t TwoWire::write(uint8_t val)
+{
+    if(_len >= WIRE_MAX_TRANS)
+        return 0;
+    _buf[_len++] = val;
+    return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    _trans++;
+    _bytes += _len + 1;
+    _clocks += WIRE_START_STOP_CLOCKS + (_len + 1) * WIRE_BYTE_CLOCKS;
+    
+    if(_monitor) _monitor(_addr, _buf, _len);
+    
+    return 0;
+}
+
+void TwoWire::setMonitor(void (*func)(uint8_t address, const uint8_t *data, int len))
+{
+    _monitor = func;
+}
+
+void TwoWire::resetStats()
+{
+    _trans = _bytes = 0;
+    _clocks = 0;
+}
+
+uint32_t TwoWire::getTransactions()
+{
+    return _trans;
+}
+
+uint32_t TwoWire::getBytes()
+{
+    return _bytes;
+}
+
+double TwoWire::getBusUs()
+{
+    return (double)_clocks * 1000000.0 / _clock;
+}
@@ -0,0 +1,79 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: i2c bus model
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SHIM_WIRE_H
+#define _SHIM_WIRE_H
+
+#include <Arduino.h>
+
+#define WIRE_MAX_TRANS 64
+
+/*
+ * Wire replacement: Transactions go nowhere, but are counted, and
+ * the time they would take on the bus is modelled: Per transaction
+ * a start and stop condition plus 9 clocks (8 bits, ack) for the 
+ * address and for every data byte. A test can register a callback
+ * to see every transaction.
+ */
+class TwoWire {
+
+    public:
+        bool    begin(int sda = -1, int scl = -1, uint32_t frequency = 100000);
+        void    setClock(uint32_t frequency);
+
+        void    beginTransmission(uint8_t address);
+        size_t  write(uint8_t val);
+        uint8_t endTransmission(bool sendStop = true);
+
+        // Bus model
+        void     setMonitor(void (*func)(uint8_t address, const uint8_t *data, int len));
+        void     resetStats();
+        uint32_t getTransactions();
+        uint32_t getBytes();
+        double   getBusUs();
+
+    private:
+        uint32_t _clock = 100000;
+        uint8_t  _addr = 0;
+        uint8_t  _buf[WIRE_MAX_TRANS];
+        int      _len = 0;
+
+        uint32_t _trans = 0;
+        uint32_t _bytes = 0;
+        uint64_t _clocks = 0;
+
+        void (*_monitor)(uint8_t address, const uint8_t *data, int len) = NULL;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: Arduino core
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+#include "shim.h"
+
+#define SHIM_PINS 40
+
+HardwareSerial Serial;
+
+static unsigned long shimMicros = 0;
+
+static int   pinLevel[SHIM_PINS];
+static void  (*pinISR[SHIM_PINS])(void);
+static void  (*pinISRArg[SHIM_PINS])(void *);
+static void  *pinArg[SHIM_PINS];
+
+void shim_setMicros(unsigned long us)
+{
+    shimMicros = us;
+}
+
+void shim_advance(unsigned long us)
+{
+    shimMicros += us;
+}
+
+void shim_setPin(uint8_t pin, int level)
+{
+    pinLevel[pin % SHIM_PINS] = level;
+}
+
+void shim_edge(uint8_t pin, int level)
+{
+    pin %= SHIM_PINS;
+    
+    if(pinLevel[pin] == level)
+        return;
+
+    pinLevel[pin] = level;
+    
+    if(pinISR[pin])    pinISR[pin]();
+    if(pinISRArg[pin]) pinISRArg[pin](pinArg[pin]);
+}
+
+unsigned long micros()
+{
+    return shimMicros;
+}
+
+unsigned long millis()
+{
+    return shimMicros / 1000;
+}
+
+void delay(uint32_t ms)
+{
+    shimMicros += ms * 1000;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if(mode == INPUT_PULLUP) pinLevel[pin % SHIM_PINS] = HIGH;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pinLevel[pin % SHIM_PINS];
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    pinLevel[pin % SHIM_PINS] = val;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+    pinISR[pin % SHIM_PINS] = isr;
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void *), void *arg, int mode)
+{
+    pinISRArg[pin % SHIM_PINS] = isr;
+    pinArg[pin % SHIM_PINS] = arg;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    pinISR[pin % SHIM_PINS] = NULL;
+    pinISRArg[pin % SHIM_PINS] = NULL;
+}
+
+// Hardware RNG: Different value on every call, like the real one
+uint32_t esp_random()
+{
+    static uint32_t x = 0x2545f491;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return x;
+}
+
+void esp_restart()
+{
+    printf("esp_restart() called\n");
+    exit(1);
+}
+
+int xPortGetCoreID()
+{
+    return 1;
+}
+
+BaseType_t xTaskCreatePinnedToCore(void (*func)(void *), const char *name, uint32_t stack,
+                                   void *arg, int prio, TaskHandle_t *handle, int core)
+{
+    return pdFAIL;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    static int mainTask;
+    
+    return &mainTask;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, uint32_t ticks)
+{
+    return 0;
+}
+
+hw_timer_t *timerBegin(uint8_t num, uint16_t divider, bool countUp)
+{
+    static hw_timer_t timers[4];
+    
+    timers[num & 3].num = num;
+    return &timers[num & 3];
+}
+
+void timerAttachInterrupt(hw_timer_t *timer, void (*isr)(void), bool edge)
+{
+}
+
+void timerAlarmWrite(hw_timer_t *timer, uint64_t value, bool reload)
+{
+}
+
+void timerAlarmEnable(hw_timer_t *timer)
+{
+}
+
+void timerAlarmDisable(hw_timer_t *timer)
+{
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    va_list args;
+    int n;
+    
+    va_start(args, format);
+    n = vprintf(format, args);
+    va_end(args);
+    
+    return n > 0 ? n : 0;
+}
+
+size_t Print::print(const char *s)
+{
+    return fputs(s, stdout) >= 0 ? strlen(s) : 0;
+}
+
+size_t Print::println(const char *s)
+{
+    return print(s) + print("\n");
+}
@@ -0,0 +1,57 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test shim: Test controls
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#ifndef _SHIM_H
+#define _SHIM_H
+
+/*
+ * Controls for the host shim: The tests set the clock and the pin 
+ * levels, and fire pin interrupts themselves. Time only advances
+ * when the test says so; millis() is derived from micros().
+ */
+
+void shim_setMicros(unsigned long us);
+void shim_advance(unsigned long us);
+
+// Set pin level without firing its interrupt
+void shim_setPin(uint8_t pin, int level);
+
+// Set pin level; fire interrupt if attached and level changed
+void shim_edge(uint8_t pin, int level);
+
+// Queue an incoming UDP packet (WiFi.h)
+void shim_udpReceive(const uint8_t *data, int len);
+
+// Number of UDP packets sent since start
+uint32_t shim_udpSent();
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test: Siddly benchmarks
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <time.h>
+
+#include "shim.h"
+
+// The game's state and helpers are static; build them in
+#include "sid_siddly.cpp"
+
+/*
+ * Benchmarks the Siddly board representation on the host:
+ * - collision tests for all pieces, rotations and positions on a
+ *   half-filled board, 
+ * - moves: pieces rotated, pushed to both walls and dropped, each
+ *   step tested for collision first, as the game does per input 
+ *   or tick,
+ * - the demo player's search (with lookahead) for every piece on 
+ *   that board: placements rated per second, and time per piece
+ *   against the shortest tick (ldelays, highest level),
+ * and plays demo games through si_frame() with simulated time, 
+ * as many pieces as two rounds through all levels take. Fails if
+ * the demo player tops out.
+ */
+
+#define BENCH_RUNS  2000
+#define MOVE_RUNS   20000
+#define SEARCH_RUNS 200
+
+#define FRAME_MS    10
+#define DEMO_SEEDS  5
+#define DEMO_PIECES (2 * NUM_LEVELS * PIECES_PER_LEVEL)
+
+// The display, text engine stubbed out (the game only draws)
+sidDisplay sid(0x74, 0x72);
+
+bool showWordSequence(const char *text, int speed, textCallback cb)
+{
+    if(cb) cb();
+    return true;
+}
+
+bool text_busy()
+{
+    return false;
+}
+
+static double seconds()
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void halfFillBoard()
+{
+    clearBoard();
+    for(int y = HEIGHT / 2; y < HEIGHT; y++) {
+        board[y] = BWALLS | (0x2aa << (BSHIFT + (y & 1)));
+    }
+}
+
+static void benchCollisions()
+{
+    uint32_t cnt = 0, hits = 0;
+    double t;
+
+    halfFillBoard();
+
+    t = seconds();
+    for(int k = 0; k < BENCH_RUNS; k++) {
+        for(int p = 0; p < NUM_PIECES; p++) {
+            for(int r = 0; r < 4; r++) {
+                for(int y = -1; y < HEIGHT; y++) {
+                    for(int x = -3; x < WIDTH; x++) {
+                        if(fits(p, r, x, y)) hits++;
+                        cnt++;
+                    }
+                }
+            }
+        }
+    }
+    t = seconds() - t;
+
+    printf("Collision tests: %u in %.3fs, %.1fM per second (%u fit)\n", 
+        cnt, t, cnt / t / 1e6, hits / BENCH_RUNS);
+}
+
+static void benchMoves()
+{
+    uint32_t moves = 0;
+    double t;
+
+    halfFillBoard();
+
+    t = seconds();
+    for(int k = 0; k < MOVE_RUNS; k++) {
+        for(int p = 0; p < NUM_PIECES; p++) {
+            for(int r = 0; r < 4; r++) {
+                cp = p;
+                cpr = 0;
+                cpx = (WIDTH - ps[cp]) / 2;
+                cpy = 0;
+                for(int i = 0; i < r; i++, moves++) {
+                    if(canRotate()) rotate();
+                }
+                for(moves++; canMoveLeft(); moves++) moveLeft();
+                for(moves++; canMoveRight(); moves++) moveRight();
+                for(moves++; canMoveDown(); moves++) moveDown();
+            }
+        }
+    }
+    t = seconds() - t;
+
+    printf("Moves: %u in %.3fs, %.1fM per second\n", moves, t, moves / t / 1e6);
+}
+
+static void benchSearch()
+{
+    double t, us;
+
+    halfFillBoard();
+
+    aiEvals = 0;
+    t = seconds();
+    for(int k = 0; k < SEARCH_RUNS; k++) {
+        for(int p = 0; p < NUM_PIECES; p++) {
+            cp = p;
+            np = (p + 1) % NUM_PIECES;
+            cpr = 0;
+            cpx = (WIDTH - ps[cp]) / 2;
+            cpy = 0;
+            aiSearch();
+        }
+    }
+    t = seconds() - t;
+    us = t * 1e6 / (SEARCH_RUNS * NUM_PIECES);
+
+    printf("Search: %u placements in %.3fs, %.2fM per second; %.1fus per piece (%.3f%% of %lums tick)\n",
+        aiEvals, t, aiEvals / t / 1e6, us, us / 10 / ldelays[NUM_LEVELS - 1], ldelays[NUM_LEVELS - 1]);
+}
+
+// Play a demo game; returns false if the player topped out
+static bool playDemo(uint32_t seed)
+{
+    int pieces = 0, lines = 0, maxLevel = 0;
+    
+    rand_setSeed(seed);
+    si_init(true);
+
+    while(pieces < DEMO_PIECES) {
+        bool removing = removeCycle;
+        int full = 0;
+
+        for(int y = 0; y < HEIGHT; y++) {
+            if(board[y] == BFULL) full++;
+        }
+        
+        shim_advance(FRAME_MS * 1000);
+        si_frame(millis(), FRAME_MS);
+        
+        if(gameOver) {
+            printf("Demo 0x%08x: Topped out after %d pieces, level %d\n", seed, pieces, level + 1);
+            si_end();
+            return false;
+        }
+        if(removing && !removeCycle) {
+            lines += full;
+            pieces++;
+        }
+        if(level > maxLevel) maxLevel = level;
+    }
+
+    si_end();
+
+    printf("Demo 0x%08x: %d pieces, %d lines, up to level %d\n", seed, pieces, lines, maxLevel + 1);
+    
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int errors = 0;
+    
+    shim_setMicros(1000);
+
+    buildPieceRows();
+
+    benchCollisions();
+    benchMoves();
+    benchSearch();
+
+    for(int i = 0; i < DEMO_SEEDS; i++) {
+        if(!playDemo(0x2545f491 + i * 0x9e3779b9)) errors++;
+    }
+
+    if(errors) {
+        printf("FAILED: %d errors\n", errors);
+        return 1;
+    }
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test: Replay of idle and time travel sequences
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "shim.h"
+
+// Idle patterns and TT sequence are static; build them in
+#include "sid_main.cpp"
+
+/*
+ * Checks that a fixed seed (rand_setSeed(), SID_RAND_SEED) replays 
+ * the animations frame by frame: Each scenario (idle modes 0-5, 
+ * and a stand-alone time travel out of idle mode 0) runs like a 
+ * boot, in a fresh process, with the seed set before the first 
+ * frame. Frames come from the frame clock (frame_loop(), as in 
+ * main_loop()) with a simulated clock; each frame is the RAM 
+ * content of both chips as last written over i2c.
+ * - Two runs with the same seed must be identical, even though the
+ *   hardware RNG (esp_random()) is consumed in between,
+ * - For the scenarios that use random numbers, a run with another
+ *   seed must differ.
+ */
+
+#define RUN_FRAMES   900
+#define TT_AT_FRAME  60
+#define SEED_A       0x12345678
+#define SEED_B       0x9e3779b9
+
+#define CHIP_RAM     (SD_CHIP_WORDS * 2)
+#define FRAME_SIZE   (2 * CHIP_RAM)
+
+static const uint8_t addresses[2] = { 0x74, 0x72 };
+
+static uint8_t chipRam[FRAME_SIZE];
+
+static const struct {
+    const char *name;
+    int         mode;
+    bool        tt;
+    bool        random;     // uses random numbers
+} scenarios[] = {
+    { "Idle 0",       0, false, true  },
+    { "Idle 1",       1, false, true  },
+    { "Idle 2",       2, false, true  },
+    { "Idle 3",       3, false, true  },
+    { "Idle 4",       4, false, false },
+    { "Idle 5",       5, false, true  },
+    { "TT from idle", 0, true,  true  }
+};
+#define NUM_SCENARIOS (int)(sizeof(scenarios) / sizeof(scenarios[0]))
+
+static uint8_t frames[3][RUN_FRAMES][FRAME_SIZE];
+
+static void busMonitor(uint8_t address, const uint8_t *data, int len)
+{
+    for(int j = 0; j < 2; j++) {
+        if(address == addresses[j] && len > 1 && data[0] == 0x00) {
+            memcpy(&chipRam[j * CHIP_RAM], data + 1, min(len - 1, CHIP_RAM));
+        }
+    }
+}
+
+// Runs in the child: Boot, set seed, write RUN_FRAMES frames to fd
+static void runScenario(int s, uint32_t seed, bool useHwRng, int fd)
+{
+    int n = 0;
+
+    shim_setMicros(1000000);
+    Wire.begin(-1, -1, 400000);
+    Wire.setMonitor(busMonitor);
+    
+    sid.begin();
+    sched_setup();
+    frame_setup();
+    frame_register(main_frame);
+    
+    if(useHwRng) {
+        for(int i = 0; i < 100; i++) esp_random();
+    }
+    
+    rand_setSeed(seed);
+    
+    idleMode = scenarios[s].mode;
+    idleInit(idleMode);
+
+    while(n < RUN_FRAMES) {
+        shim_advance(1000);
+        if(!frame_loop())
+            continue;
+        if(scenarios[s].tt && n == TT_AT_FRAME) {
+            timeTravel(false, ETTO_LEAD);
+        }
+        if(write(fd, chipRam, FRAME_SIZE) != FRAME_SIZE)
+            break;
+        n++;
+    }
+}
+
+// Fork a "boot" running scenario s; collect its frames
+static bool record(int s, uint32_t seed, bool useHwRng, uint8_t (*buf)[FRAME_SIZE])
+{
+    int fds[2], status, n = 0;
+    pid_t pid;
+
+    if(pipe(fds) || (pid = fork()) < 0) {
+        printf("Cannot fork\n");
+        return false;
+    }
+
+    if(!pid) {
+        close(fds[0]);
+        runScenario(s, seed, useHwRng, fds[1]);
+        close(fds[1]);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    while(n < RUN_FRAMES * FRAME_SIZE) {
+        ssize_t r = read(fds[0], (uint8_t *)buf + n, RUN_FRAMES * FRAME_SIZE - n);
+        if(r <= 0) break;
+        n += r;
+    }
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    if(n != RUN_FRAMES * FRAME_SIZE || !WIFEXITED(status) || WEXITSTATUS(status)) {
+        printf("%s: Run failed (%d of %d frames)\n", scenarios[s].name, n / FRAME_SIZE, RUN_FRAMES);
+        return false;
+    }
+
+    return true;
+}
+
+static int firstDiff(uint8_t (*a)[FRAME_SIZE], uint8_t (*b)[FRAME_SIZE])
+{
+    for(int i = 0; i < RUN_FRAMES; i++) {
+        if(memcmp(a[i], b[i], FRAME_SIZE)) return i;
+    }
+    return -1;
+}
+
+static int countChanges(uint8_t (*a)[FRAME_SIZE])
+{
+    int c = 0;
+    
+    for(int i = 1; i < RUN_FRAMES; i++) {
+        if(memcmp(a[i], a[i - 1], FRAME_SIZE)) c++;
+    }
+    return c;
+}
+
+int main(int argc, char **argv)
+{
+    int errors = 0;
+
+    fflush(stdout);
+
+    for(int s = 0; s < NUM_SCENARIOS; s++) {
+        int same, other, changes;
+        
+        if(!record(s, SEED_A, false, frames[0]) ||
+           !record(s, SEED_A, true,  frames[1]) ||
+           !record(s, SEED_B, false, frames[2])) {
+            errors++;
+            continue;
+        }
+
+        same = firstDiff(frames[0], frames[1]);
+        other = firstDiff(frames[0], frames[2]);
+        changes = countChanges(frames[0]);
+
+        printf("%-14s %d frames, %3d changes; same seed: ", scenarios[s].name, RUN_FRAMES, changes);
+        if(same < 0) {
+            printf("identical");
+        } else {
+            printf("DIFFERS from frame %d", same);
+            errors++;
+        }
+        printf("; other seed: ");
+        if(other >= 0) {
+            printf("differs from frame %d\n", other);
+        } else {
+            printf("identical\n");
+            if(scenarios[s].random) errors++;
+        }
+        if(!changes) {
+            printf("  no animation\n");
+            errors++;
+        }
+    }
+
+    if(errors) {
+        printf("FAILED: %d errors\n", errors);
+        return 1;
+    }
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test: Stubs for the time travel test
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+
+#include "sid_settings.h"
+#include "sid_wifi.h"
+#include "sid_sa.h"
+#include "sid_rec.h"
+
+/*
+ * Modules sid_main.cpp calls, but which need the file system,
+ * WiFi or i2s: Settings are defaults and never saved, there is no
+ * mic (the Spectrum Analyzer can't be activated), nothing is 
+ * recorded.
+ */
+
+struct Settings settings;
+struct IPSettings ipsettings;
+
+bool haveSD = false;
+bool FlashROMode = false;
+
+bool loadBrightness() { return false; }
+void saveBrightness(bool useCache) {}
+bool loadIdlePat() { return false; }
+void saveIdlePat(bool useCache) {}
+bool loadIRLock() { return false; }
+void saveIRLock(bool useCache) {}
+bool saveIRKeys() { return false; }
+void deleteIRKeys() {}
+void deleteIpSettings() {}
+void write_settings() {}
+void unmount_fs() {}
+
+bool openDataFileRead(const char *fn, File& f) { return false; }
+
+void updateConfigPortalStrictValue() {}
+
+bool wifi_getIP(uint8_t& a, uint8_t& b, uint8_t& c, uint8_t& d)
+{
+    a = 192; b = 168; c = 4; d = 1;
+    return true;
+}
+
+bool isIp(char *str) { return false; }
+
+// Spectrum Analyzer: No mic
+bool saActive = false;
+bool doPeaks = false;
+
+static int ampFact = 100;
+
+void sa_activate(bool init, unsigned long start_Delay) {}
+void sa_deactivate() { saActive = false; }
+
+int sa_setAmpFact(int newAmpFact)
+{
+    int old = ampFact;
+
+    if(newAmpFact >= 0) {
+        ampFact = newAmpFact;
+    }
+
+    return old;
+}
+
+void sa_loop() {}
+void sa_frame(unsigned long now, unsigned long delta) {}
+
+bool rec_start(int num) { return false; }
+void rec_stop() {}
+bool rec_isActive() { return false; }
+bool rec_isBusy() { return false; }
@@ -0,0 +1,290 @@
+/*
+ * -------------------------------------------------------------------
+ * CircuitSetup.us Status Indicator Display
+ * (C) 2023 Thomas Winischhofer (A10001986)
+ * https://github.com/realA10001986/SID
+ * https://sid.backtothefutu.re
+ *
+ * Host test: Time travel sequence
+ *
+ * -------------------------------------------------------------------
+ * License: MIT
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, 
+ * merge, publish, distribute, sublicense, and/or sell copies of the 
+ * Software, and to permit persons to whom the Software is furnished to 
+ * do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "shim.h"
+
+// The phase engine and its state are static; build them in
+#include "sid_main.cpp"
+
+/*
+ * Drives the time travel sequence (tt_frame(), the phase table in
+ * sid_main.cpp) with a simulated clock, one frame every FRAME_MS,
+ * for each trigger source:
+ * - stand-alone (button/IR): timeTravel() as main_loop() calls it 
+ *   without TCD,
+ * - TCD by wire: TT_IN_PIN high during the time travel, low for 
+ *   re-entry,
+ * - BTTFN: TT, re-entry and abort notifications as UDP packets, 
+ *   through BTTFNCheckPacket().
+ * Checks when each phase starts (P0 for P0duration, P1 for P1_DUR
+ * or until re-entry, P2 without SA ends right away), that an abort
+ * ends the sequence at once, and that stand-alone and TCD-triggered
+ * time travels with the same lead and tunnel time have identical 
+ * timing: Same P0 steps at the same times, same i2c traffic.
+ */
+
+#define FRAME_MS   10
+#define RUN_MAX    30000
+#define MAX_STEPS  64
+#define TT_SEED    0x12345678
+
+#define TRIG_STANDALONE  0
+#define TRIG_WIRE        1
+#define TRIG_BTTFN       2
+
+static const char *trigNames[3] = { "stand-alone", "wire", "BTTFN" };
+
+typedef struct {
+    long          phase[TT_NUM_PHASES + 1]; // start of each phase, end (ms after trigger)
+    int           steps;                    // P0 sequence steps
+    unsigned long stepAt[MAX_STEPS];
+    uint32_t      busHash;                  // FNV-1 over all i2c traffic
+} ttRun;
+
+static int errors = 0;
+
+static uint32_t busHash;
+
+static void busMonitor(uint8_t address, const uint8_t *data, int len)
+{
+    busHash = (busHash * 0x01000193) ^ address;
+    for(int i = 0; i < len; i++) {
+        busHash = (busHash * 0x01000193) ^ data[i];
+    }
+}
+
+static void sendBTTFN(uint8_t cmd, uint16_t par)
+{
+    uint8_t buf[BTTF_PACKET_SIZE] = { 0 };
+    uint8_t a = 0;
+
+    memcpy(buf, BTTFUDPHD, 4);
+    buf[4] = BTTFN_VERSION | 0x40;
+    buf[5] = cmd;
+    buf[6] = par & 0xff;
+    buf[7] = par >> 8;
+    for(int i = 4; i < BTTF_PACKET_SIZE - 1; i++) {
+        a += buf[i] ^ 0x55;
+    }
+    buf[BTTF_PACKET_SIZE - 1] = a;
+
+    shim_udpReceive(buf, BTTF_PACKET_SIZE);
+    BTTFNCheckPacket();
+}
+
+static void resetState()
+{
+    TTrunning = false;
+    TCDconnected = false;
+    networkTimeTravel = networkTCDTT = networkReentry = networkAbort = false;
+    sidBaseLine = strictBaseLine = 0;
+    LMState = LMIdx = id5idx = 0;
+    lastChange = 0;
+    sa_setAmpFact(100);
+    shim_setPin(TT_IN_PIN, LOW);
+    
+    rand_setSeed(TT_SEED);
+    
+    sid.clearBuf();
+    sid.show();
+}
+
+/*
+ * Trigger a time travel and run it to the end. Re-entry (wire,
+ * BTTFN) and abort (BTTFN) are signalled at the given times 
+ * after the trigger, if not negative.
+ */
+static void runTT(int trig, uint16_t lead, long reentryAt, long abortAt, ttRun *r)
+{
+    unsigned long t0;
+    
+    memset(r, 0, sizeof(*r));
+    for(int i = 0; i <= TT_NUM_PHASES; i++) r->phase[i] = -1;
+
+    resetState();
+    t0 = millis();
+    busHash = 0x811c9dc5;
+
+    switch(trig) {
+    case TRIG_STANDALONE:
+        timeTravel(false, lead);
+        break;
+    case TRIG_WIRE:
+        TCDconnected = true;
+        shim_setPin(TT_IN_PIN, HIGH);
+        timeTravel(true, lead);
+        break;
+    case TRIG_BTTFN:
+        sendBTTFN(BTTFN_NOT_TT, lead);
+        // As in main_loop()
+        if(networkTimeTravel) {
+            networkTimeTravel = false;
+            timeTravel(networkTCDTT, networkLead);
+        }
+        break;
+    }
+
+    if(!TTrunning) {
+        printf("%s: Time travel not started\n", trigNames[trig]);
+        errors++;
+        return;
+    }
+    r->phase[0] = 0;
+
+    while(TTrunning && millis() - t0 < RUN_MAX) {
+        long t;
+        int phase = TTphase, cnt = TTcnt, newPhase;
+        
+        shim_advance(FRAME_MS * 1000);
+        t = millis() - t0;
+
+        if(reentryAt >= 0 && t >= reentryAt) {
+            reentryAt = -1;
+            if(trig == TRIG_WIRE) {
+                shim_setPin(TT_IN_PIN, LOW);
+            } else if(trig == TRIG_BTTFN) {
+                sendBTTFN(BTTFN_NOT_REENTRY, 0);
+            }
+        }
+        if(abortAt >= 0 && t >= abortAt) {
+            abortAt = -1;
+            sendBTTFN(BTTFN_NOT_ABORT_TT, 0);
+        }
+
+        tt_frame(millis());
+        sid.flush();
+
+        newPhase = TTrunning ? TTphase : TT_NUM_PHASES;
+        for(int i = phase + 1; i <= newPhase; i++) {
+            r->phase[i] = t;
+        }
+        if(phase == 0 && TTcnt != cnt && r->steps < MAX_STEPS) {
+            r->stepAt[r->steps++] = t;
+        }
+    }
+    
+    r->busHash = busHash;
+
+    if(TTrunning) {
+        printf("%s: Time travel did not end within %dms\n", trigNames[trig], RUN_MAX);
+        errors++;
+    }
+}
+
+static void printRun(const char *name, const ttRun *r)
+{
+    printf("%-28s P1 %5ldms, P2 %5ldms, end %5ldms; %2d steps, i2c %08x\n",
+        name, r->phase[1], r->phase[2], r->phase[3], r->steps, r->busHash);
+}
+
+static void expectPhases(const char *name, const ttRun *r, long p1, long p2, long end)
+{
+    printRun(name, r);
+    
+    if(r->phase[1] != p1 || r->phase[2] != p2 || r->phase[3] != end) {
+        printf("  expected P1 %ldms, P2 %ldms, end %ldms\n", p1, p2, end);
+        errors++;
+    }
+}
+
+static void expectSameTiming(const char *name, const ttRun *a, const ttRun *b)
+{
+    bool same = (a->steps == b->steps) && (a->busHash == b->busHash);
+
+    for(int i = 0; i <= TT_NUM_PHASES; i++) {
+        if(a->phase[i] != b->phase[i]) same = false;
+    }
+    for(int i = 0; same && i < a->steps; i++) {
+        if(a->stepAt[i] != b->stepAt[i]) same = false;
+    }
+
+    printf("%-28s %s\n", name, same ? "identical" : "DIFFERENT");
+    if(!same) errors++;
+}
+
+int main(int argc, char **argv)
+{
+    ttRun sa, wire, net, r;
+
+    shim_setMicros(1000000);
+    Wire.begin(-1, -1, 400000);
+    
+    sid.begin();
+    sched_setup();
+    frame_setup();
+    sidUDP = &bttfUDP;
+    Wire.setMonitor(busMonitor);
+
+    // Stand-alone: P0_DUR, P1_DUR; no SA, so P2 ends at once
+    runTT(TRIG_STANDALONE, ETTO_LEAD, -1, -1, &sa);
+    expectPhases("Stand-alone", &sa, P0_DUR, P0_DUR + P1_DUR, P0_DUR + P1_DUR);
+    if(!sa.steps) {
+        printf("  no P0 sequence steps\n");
+        errors++;
+    }
+
+    // Wire: ETTO_LEAD, P1 until TT_IN_PIN goes low
+    runTT(TRIG_WIRE, ETTO_LEAD, ETTO_LEAD + 3000, -1, &r);
+    expectPhases("Wire, re-entry after 3s", &r, ETTO_LEAD, ETTO_LEAD + 3000, ETTO_LEAD + 3000);
+
+    // BTTFN: lead from packet, P1 until re-entry packet
+    runTT(TRIG_BTTFN, 3000, 7000, -1, &r);
+    expectPhases("BTTFN, lead 3s, re-entry 7s", &r, 3000, 7000, 7000);
+    runTT(TRIG_BTTFN, 0, 2000, -1, &r);
+    expectPhases("BTTFN, no lead, re-entry 2s", &r, FRAME_MS, 2000, 2000);
+
+    // BTTFN abort: In P0 and in P1, sequence ends at once
+    runTT(TRIG_BTTFN, ETTO_LEAD, -1, 1500, &r);
+    expectPhases("BTTFN, abort in P0", &r, 1500, 1500, 1500);
+    runTT(TRIG_BTTFN, 3000, -1, 4000, &r);
+    expectPhases("BTTFN, abort in P1", &r, 3000, 4000, 4000);
+
+    // Stand-alone vs. TCD with same lead and tunnel duration
+    #if ETTO_LEAD == P0_DUR
+    runTT(TRIG_WIRE, ETTO_LEAD, P0_DUR + P1_DUR, -1, &wire);
+    expectSameTiming("Stand-alone vs. wire", &sa, &wire);
+    #endif
+    runTT(TRIG_BTTFN, P0_DUR, P0_DUR + P1_DUR, -1, &net);
+    expectSameTiming("Stand-alone vs. BTTFN", &sa, &net);
+
+    if(errors) {
+        printf("FAILED: %d errors\n", errors);
+        return 1;
+    }
+
+    printf("OK\n");
+
+    return 0;
+}